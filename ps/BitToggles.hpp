@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Toggle (Hamming distance) counting for data-dependent energy events, see
+ * PowerModelChannelOutIf::reportDataEvent.
+ *
+ * Wide values are arrays of 64-bit words, least significant word first. The
+ * kernels are plain loops over whole words so the compiler can vectorize
+ * them; build with e.g. -mpopcnt or -mavx512vpopcntdq to get hardware
+ * popcount instructions.
+ */
+
+//! Number of set bits in a word
+inline unsigned int popcount64(const uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned int>(__builtin_popcountll(x));
+#else
+  uint64_t v = x - ((x >> 1) & 0x5555555555555555ULL);
+  v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+  v = (v + (v >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<unsigned int>((v * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * @brief countToggles number of bits that differ between two values.
+ * @param a, b values, (width + 63) / 64 words each
+ * @param width width of the values in bits, higher bits are ignored
+ */
+inline unsigned int countToggles(const uint64_t *a, const uint64_t *b,
+                                 const unsigned int width) {
+  const unsigned int full = width / 64;
+  unsigned int toggles = 0;
+  for (unsigned int i = 0; i < full; ++i) {
+    toggles += popcount64(a[i] ^ b[i]);
+  }
+  if (width % 64 != 0) {
+    const uint64_t mask = (uint64_t(1) << (width % 64)) - 1;
+    toggles += popcount64((a[full] ^ b[full]) & mask);
+  }
+  return toggles;
+}
+
+/**
+ * @brief countBurstToggles number of bit toggles over a burst of successive
+ * values on the same lines.
+ * @param prev value on the lines before the burst
+ * @param beats nBeats values, (width + 63) / 64 words each, back to back
+ * @param nBeats number of values in the burst
+ * @param width width of the values in bits
+ */
+inline unsigned int countBurstToggles(const uint64_t *prev,
+                                      const uint64_t *beats,
+                                      const unsigned int nBeats,
+                                      const unsigned int width) {
+  if (nBeats == 0) {
+    return 0;
+  }
+  const unsigned int words = (width + 63) / 64;
+  unsigned int toggles = countToggles(prev, beats, width);
+  if (width % 64 == 0) {
+    // No masking, successive beats are one flat pass over the array
+    return toggles + countToggles(beats, beats + words, width * (nBeats - 1));
+  }
+  for (unsigned int i = 1; i < nBeats; ++i) {
+    toggles += countToggles(beats + (i - 1) * words, beats + i * words, width);
+  }
+  return toggles;
+}
@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <iostream>
 #include <string>
+#include "PowerModelDatabase.hpp"
 #include "PowerModelStateBase.hpp"
 
 /**
@@ -25,18 +26,18 @@ class ConstantCurrentState : public PowerModelStateBase {
 
   /**
    * @brief alternative constructor which attempts to set the current from the
-   * config item named "<moduleName> <name>". If the config does not contain
-   * that name, 0.0 is used.
-   * @param moduleName module name used for finding the current from the config.
+   * power model database item named "<moduleName> <name>". If the database
+   * does not contain that name, 0.0 is used.
+   * @param moduleName module name used for finding the current from the
+   * database.
    * @param name name of this state.
    */
-  /*
   ConstantCurrentState(const std::string moduleName, const std::string name)
       : PowerModelStateBase(name),
-        current(Config::get().contains(moduleName + " " + name)
-                    ? Config::get().getDouble(moduleName + " " + name)
+        current(PowerModelDatabase::get().contains(moduleName + " " + name)
+                    ? PowerModelDatabase::get().getDouble(moduleName + " " +
+                                                          name)
                     : 0.0) {}
-		    */
 
   virtual double calculateCurrent([
       [maybe_unused]] const double supplyVoltage) const override {
@@ -11,6 +11,7 @@
 #include <stdint.h>
 #include <iostream>
 #include <string>
+#include "PowerModelDatabase.hpp"
 #include "PowerModelEventBase.hpp"
 
 /**
@@ -25,18 +26,18 @@ class ConstantEnergyEvent : public PowerModelEventBase {
 
   /**
    * @brief alternative constructor which attempts to set the energy from the
-   * config item named "<moduleName> <name>". If the config does not contain
-   * that name, 0.0 is used.
-   * @param moduleName module name used for finding the energy from the config.
+   * power model database item named "<moduleName> <name>". If the database
+   * does not contain that name, 0.0 is used.
+   * @param moduleName module name used for finding the energy from the
+   * database.
    * @param name name of this event.
    */
-  /*
   ConstantEnergyEvent(const std::string moduleName, const std::string name)
       : PowerModelEventBase(name),
-        energy(Config::get().contains(moduleName + " " + name)
-                   ? Config::get().getDouble(moduleName + " " + name)
+        energy(PowerModelDatabase::get().contains(moduleName + " " + name)
+                   ? PowerModelDatabase::get().getDouble(moduleName + " " +
+                                                         name)
                    : 0.0) {}
-		   */
 
   virtual double calculateEnergy([
       [maybe_unused]] const double supplyVoltage) const override {
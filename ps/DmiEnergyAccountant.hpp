@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "PowerModelChannelIf.hpp"
+
+#include <cstdint>
+#include <systemc>
+#include <vector>
+
+/**
+ * @brief DmiEnergyAccountant counts accesses made through DMI pointers, which
+ * the target's model never sees, and reports them as the target's power model
+ * events.
+ *
+ * An ISS front-end adds a region for each DMI grant, mapped to the events the
+ * target registered for reads and writes, counts its accesses with read() and
+ * write() (an increment each), and calls flush() at quantum boundaries to
+ * report the aggregated counts in one batch.
+ */
+class DmiEnergyAccountant : public sc_core::sc_module {
+ public:
+  sc_core::sc_port<PowerModelChannelOutIf> powerModelPort{"powerModelPort"};
+
+  //! Access kinds
+  enum Access { Read = 0, Write = 1 };
+
+  //! Constructor
+  explicit DmiEnergyAccountant(const sc_core::sc_module_name name)
+      : sc_core::sc_module(name) {}
+
+  /**
+   * @brief addRegion add a DMI region.
+   * @param start, end first and last address of the region
+   * @param readEventId event reported per read, -1 to ignore reads
+   * @param writeEventId event reported per write, -1 to ignore writes
+   * @retval region id
+   */
+  unsigned int addRegion(const uint64_t start, const uint64_t end,
+                         const int readEventId, const int writeEventId) {
+    m_regions.push_back({start, end, {readEventId, writeEventId}, true});
+    m_counts.push_back(0);
+    m_counts.push_back(0);
+    return m_regions.size() - 1;
+  }
+
+  /**
+   * @brief findRegion find the valid region containing an address.
+   * @retval region id, or -1 if no region contains the address
+   */
+  int findRegion(const uint64_t address) const {
+    for (unsigned int i = 0; i < m_regions.size(); ++i) {
+      const auto &r = m_regions[i];
+      if (r.valid && address >= r.start && address <= r.end) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  //! Count n reads from a region
+  void read(const unsigned int region, const unsigned int n = 1) {
+    m_counts[2 * region + Read] += n;
+  }
+
+  //! Count n writes to a region
+  void write(const unsigned int region, const unsigned int n = 1) {
+    m_counts[2 * region + Write] += n;
+  }
+
+  /**
+   * @brief flush report the counts of all regions to the channel in one
+   * batch, and reset them. Call at quantum boundaries.
+   */
+  void flush() {
+    m_batch.clear();
+    for (unsigned int i = 0; i < m_counts.size(); ++i) {
+      const int eventId = m_regions[i / 2].eventIds[i % 2];
+      if (m_counts[i] != 0 && eventId >= 0) {
+        m_batch.push_back({static_cast<unsigned int>(eventId), m_counts[i]});
+      }
+      m_counts[i] = 0;
+    }
+    if (!m_batch.empty()) {
+      powerModelPort->reportEvents(m_batch);
+    }
+  }
+
+  /**
+   * @brief invalidate flush, then invalidate the regions overlapping an
+   * address range, e.g. from invalidate_direct_mem_ptr. Their ids are not
+   * reused.
+   */
+  void invalidate(const uint64_t start, const uint64_t end) {
+    flush();
+    for (auto &r : m_regions) {
+      if (r.start <= end && start <= r.end) {
+        r.valid = false;
+      }
+    }
+  }
+
+ private:
+  struct Region {
+    uint64_t start;
+    uint64_t end;
+    int eventIds[2];
+    bool valid;
+  };
+
+  std::vector<Region> m_regions;
+
+  //! Pending counts, m_counts[2 * region + access]
+  std::vector<unsigned int> m_counts;
+
+  //! Reused batch buffer
+  std::vector<PowerModelEventCount> m_batch;
+};
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/HarvesterTrace.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+//! Header of a trace file, followed by `count` samples
+struct TraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t sampleSize;
+  uint64_t count;
+};
+
+const char traceMagic[8] = {'F', 'U', 'S', 'E', 'D', 'H', 'T', 'R'};
+} // namespace
+
+const uint32_t HarvesterTrace::formatVersion;
+
+HarvesterTrace::HarvesterTrace(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(
+        fmt::format("HarvesterTrace::HarvesterTrace can't open {:s}", path));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(TraceHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format(
+        "HarvesterTrace::HarvesterTrace {:s} is not a trace file", path));
+  }
+  m_map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (m_map == MAP_FAILED) {
+    m_map = nullptr;
+    throw std::runtime_error(
+        fmt::format("HarvesterTrace::HarvesterTrace can't map {:s}", path));
+  }
+  m_mapSize = st.st_size;
+
+  const auto hdr = static_cast<const TraceHeader *>(m_map);
+  if (std::memcmp(hdr->magic, traceMagic, sizeof(traceMagic)) != 0 ||
+      hdr->version != formatVersion || hdr->sampleSize != sizeof(Sample) ||
+      hdr->count == 0 ||
+      m_mapSize != sizeof(TraceHeader) + hdr->count * sizeof(Sample)) {
+    munmap(m_map, m_mapSize);
+    m_map = nullptr;
+    throw std::runtime_error(fmt::format(
+        "HarvesterTrace::HarvesterTrace {:s} is not a valid version {:d} "
+        "trace file",
+        path, formatVersion));
+  }
+  m_samples = reinterpret_cast<const Sample *>(static_cast<const char *>(m_map) +
+                                               sizeof(TraceHeader));
+  m_count = hdr->count;
+}
+
+HarvesterTrace::~HarvesterTrace() {
+  if (m_map != nullptr) {
+    munmap(m_map, m_mapSize);
+  }
+}
+
+void HarvesterTrace::convertCsv(const std::string &csvPath,
+                                const std::string &tracePath) {
+  std::ifstream in(csvPath);
+  if (!in.good()) {
+    throw std::runtime_error(
+        fmt::format("HarvesterTrace::convertCsv can't open {:s}", csvPath));
+  }
+
+  std::vector<Sample> samples;
+  std::string line;
+  size_t lineNumber = 0;
+  while (std::getline(in, line)) {
+    ++lineNumber;
+    if (line.empty()) {
+      continue;
+    }
+    Sample s;
+    if (std::sscanf(line.c_str(), "%lf,%lf", &s.time, &s.power) != 2) {
+      if (lineNumber == 1) {
+        continue; // Header
+      }
+      throw std::invalid_argument(
+          fmt::format("HarvesterTrace::convertCsv malformed line {:d} in {:s}",
+                      lineNumber, csvPath));
+    }
+    if (!samples.empty() && s.time <= samples.back().time) {
+      throw std::invalid_argument(fmt::format(
+          "HarvesterTrace::convertCsv time not increasing at line {:d} in "
+          "{:s}",
+          lineNumber, csvPath));
+    }
+    samples.push_back(s);
+  }
+  if (samples.empty()) {
+    throw std::invalid_argument(
+        fmt::format("HarvesterTrace::convertCsv no samples in {:s}", csvPath));
+  }
+
+  TraceHeader hdr;
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr.magic, traceMagic, sizeof(traceMagic));
+  hdr.version = formatVersion;
+  hdr.sampleSize = sizeof(Sample);
+  hdr.count = samples.size();
+
+  // Write to a temporary file and rename, so a running simulation never maps
+  // a partially written trace
+  const auto tmpPath = fmt::format("{:s}.{:d}.tmp", tracePath, getpid());
+  {
+    std::ofstream f(tmpPath,
+                    std::ios::out | std::ios::binary | std::ios::trunc);
+    f.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    f.write(reinterpret_cast<const char *>(samples.data()),
+            samples.size() * sizeof(Sample));
+    if (!f.good()) {
+      std::remove(tmpPath.c_str());
+      throw std::runtime_error(fmt::format(
+          "HarvesterTrace::convertCsv can't write {:s}", tracePath));
+    }
+  }
+  if (std::rename(tmpPath.c_str(), tracePath.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    throw std::runtime_error(fmt::format(
+        "HarvesterTrace::convertCsv can't write {:s}", tracePath));
+  }
+}
+
+size_t HarvesterTrace::segment(const double t) const {
+  const auto end = m_samples + m_count;
+  const auto it = std::upper_bound(
+      m_samples, end, t,
+      [](const double val, const Sample &s) { return val < s.time; });
+  return it == m_samples ? 0 : it - m_samples - 1;
+}
+
+double HarvesterTrace::powerAt(const double t, size_t hint) const {
+  // Check the hinted segment and the next one before searching
+  if (!(hint < m_count && m_samples[hint].time <= t &&
+        (hint + 1 == m_count || t < m_samples[hint + 1].time))) {
+    if (hint + 2 < m_count && m_samples[hint + 1].time <= t &&
+        t < m_samples[hint + 2].time) {
+      ++hint;
+    } else {
+      hint = segment(t);
+    }
+  }
+  const Sample &a = m_samples[hint];
+  if (t <= a.time || hint + 1 == m_count) {
+    return a.power;
+  }
+  const Sample &b = m_samples[hint + 1];
+  return a.power + (b.power - a.power) * (t - a.time) / (b.time - a.time);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief HarvesterTrace read-only, memory-mapped (time, power) trace, e.g. a
+ * recorded solar or RF harvester output.
+ *
+ * The trace file is a binary header followed by samples sorted by time. Use
+ * convertCsv to create one from a csv file, once, instead of parsing the csv
+ * at every simulation launch. The file is memory-mapped, so only the pages
+ * around the simulated time are ever read.
+ *
+ * Power is linearly interpolated between samples, and held constant before
+ * the first and after the last sample.
+ */
+class HarvesterTrace {
+ public:
+  //! Trace file format version. Bump when the layout changes.
+  static const uint32_t formatVersion = 1;
+
+  //! One trace sample
+  struct Sample {
+    double time;  // [s]
+    double power; // [W]
+  };
+
+  /**
+   * @brief Constructor, maps a binary trace file.
+   * @param path path to a trace file created by convertCsv
+   */
+  explicit HarvesterTrace(const std::string &path);
+
+  //! Destructor, unmaps the trace
+  ~HarvesterTrace();
+
+  HarvesterTrace(const HarvesterTrace &) = delete;
+  HarvesterTrace &operator=(const HarvesterTrace &) = delete;
+
+  /**
+   * @brief convertCsv convert a csv trace with one "time,power" line per
+   * sample (seconds, watts) into a binary trace file. A non-numeric first
+   * line is skipped as a header. Samples must be sorted by time.
+   * @param csvPath path to the csv trace
+   * @param tracePath path of the binary trace to write
+   */
+  static void convertCsv(const std::string &csvPath,
+                         const std::string &tracePath);
+
+  //! Number of samples
+  size_t size() const { return m_count; }
+
+  //! Sample by index
+  const Sample &operator[](const size_t i) const { return m_samples[i]; }
+
+  /**
+   * @brief segment index of the last sample at or before t, i.e. t lies in
+   * [sample(i).time, sample(i + 1).time). Binary search.
+   * @param t time in seconds
+   * @retval sample index, or 0 if t is before the first sample
+   */
+  size_t segment(const double t) const;
+
+  /**
+   * @brief powerAt interpolated power at time t.
+   * @param t time in seconds
+   * @param hint segment index to try before searching, e.g. the result of the
+   * previous call for monotonic t
+   */
+  double powerAt(const double t, size_t hint = 0) const;
+
+ private:
+  void *m_map = nullptr;
+  size_t m_mapSize = 0;
+  const Sample *m_samples = nullptr;
+  size_t m_count = 0;
+};
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "HarvesterTrace.hpp"
+#include "PowerSupplies.hpp"
+#include "StorageCapacitor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+#include <string>
+#include <systemc>
+
+/**
+ * @brief HarvesterTracePlayer plays back a HarvesterTrace as a harvester
+ * power source.
+ *
+ * The output power is held between wakeups. The player wakes up only when the
+ * interpolated trace power deviates from the held power by more than a
+ * tolerance, at the exact time it does so. Samples in between are skipped
+ * without scheduling anything, so slowly varying or flat stretches of a long
+ * trace cost a single wakeup.
+ *
+ * The output is published through a callback and powerChangedEvent, or
+ * directly as the source of a StorageCapacitor, see drive().
+ */
+SC_MODULE(HarvesterTracePlayer) {
+  //! Callback type, invoked with the new power in watts
+  typedef std::function<void(const double power)> PowerCallback;
+
+  /**
+   * @brief Constructor
+   * @param name module name
+   * @param tracePath path to a binary trace, see HarvesterTrace::convertCsv
+   * @param tolerance power deviation that triggers an update [W], must be
+   * positive
+   */
+  HarvesterTracePlayer(const sc_core::sc_module_name name,
+                       const std::string &tracePath, const double tolerance)
+      : sc_core::sc_module(name), m_trace(tracePath), m_tolerance(tolerance) {
+    // Also rejects NaN. Without a tolerance the player would wake up every
+    // time unit on a ramp
+    if (!(m_tolerance > 0.0)) {
+      throw std::invalid_argument(fmt::format(
+          "HarvesterTracePlayer::HarvesterTracePlayer tolerance must be "
+          "positive, got {:g}",
+          m_tolerance));
+    }
+    SC_HAS_PROCESS(HarvesterTracePlayer);
+    SC_METHOD(process);
+  }
+
+  //! Set a callback that receives the power whenever it is updated
+  void setCallback(PowerCallback callback) { m_callback = std::move(callback); }
+
+  /**
+   * @brief drive set the trace power as the constant-power source of a
+   * storage capacitor.
+   * @param capacitor capacitor to drive
+   * @param currentLimit source current limit [A]
+   * @param voltageLimit source voltage limit [V]
+   */
+  void drive(StorageCapacitor & capacitor, const double currentLimit,
+             const double voltageLimit) {
+    setCallback([&capacitor, currentLimit, voltageLimit](const double p) {
+      capacitor.setSource(ConstantPowerSupply(p, currentLimit, voltageLimit));
+    });
+  }
+
+  //! Power held since the last update [W]
+  double getPower() const { return m_power; }
+
+  //! Event triggered whenever the power is updated
+  const sc_core::sc_event &powerChangedEvent() const {
+    return m_powerChangedEvent;
+  }
+
+  //! Number of updates so far
+  uint64_t updateCount() const { return m_updates; }
+
+  void process() {
+    const double t = sc_core::sc_time_stamp().to_seconds();
+    m_segment = m_trace.segment(t);
+    m_power = m_trace.powerAt(t, m_segment);
+    ++m_updates;
+    if (m_callback) {
+      m_callback(m_power);
+    }
+    m_powerChangedEvent.notify(sc_core::SC_ZERO_TIME);
+
+    const double next = nextDeviation(t);
+    if (std::isfinite(next)) {
+      // At least one time unit, steps in the trace must not stall time
+      next_trigger(std::max(sc_core::sc_time::from_seconds(next - t),
+                            sc_core::sc_get_time_resolution()));
+    } else {
+      next_trigger(m_neverEvent);
+    }
+  }
+
+ private:
+  /**
+   * @brief nextDeviation earliest time after t at which the trace power
+   * leaves m_power +/- m_tolerance, or infinity if it never does. Walks the
+   * trace forward from m_segment.
+   */
+  double nextDeviation(const double t) const {
+    double ta = t;
+    double pa = m_power;
+    for (size_t i = m_segment; i + 1 < m_trace.size(); ++i) {
+      const double tb = m_trace[i + 1].time;
+      const double pb = m_trace[i + 1].power;
+      if (tb <= ta) {
+        continue;
+      }
+      if (std::fabs(pb - m_power) > m_tolerance) {
+        // Linear within the segment, solve for the crossing
+        const double target =
+            m_power + (pb > m_power ? m_tolerance : -m_tolerance);
+        return ta + (target - pa) / (pb - pa) * (tb - ta);
+      }
+      ta = tb;
+      pa = pb;
+    }
+    return std::numeric_limits<double>::infinity();
+  }
+
+  const HarvesterTrace m_trace;
+  const double m_tolerance;
+  double m_power = 0.0;
+  size_t m_segment = 0;
+  uint64_t m_updates = 0;
+  PowerCallback m_callback;
+  sc_core::sc_event m_powerChangedEvent{"powerChangedEvent"};
+  //! Never notified, used to stop the process once the trace has ended
+  sc_core::sc_event m_neverEvent{"neverEvent"};
+};
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "PowerModelEventBase.hpp"
+
+/**
+ * Power model event whose energy depends on the history of its occurrences,
+ * e.g. DRAM row-buffer hits vs. misses or read-after-write turnarounds.
+ *
+ * The history is a small state machine. Each occurrence carries a symbol
+ * (e.g. the accessed row, or read/write); the energy of the occurrence and
+ * the next state are looked up in tables indexed by [state][symbol]. Report
+ * occurrences with PowerModelChannelOutIf::reportHistoryEvent. The channel
+ * keeps pointers to the tables, sharing ownership of the event, and steps the
+ * state machine inline. Plain reportEvent calls step it with symbol 0, in
+ * report order.
+ *
+ * The state machine starts in state 0. calculateEnergy returns the energy of
+ * symbol 0 in state 0, as a representative value for logging.
+ */
+class HistoryEnergyEvent : public PowerModelEventBase {
+ public:
+  //! Maximum number of states, state indices are stored as bytes
+  static const unsigned int maxStates = 256;
+
+  /**
+   * @brief Constructor
+   * @param name name of this event
+   * @param nStates_ number of states
+   * @param nSymbols_ number of symbols
+   * @param next_ next state, [state * nSymbols + symbol]
+   * @param energy_ occurrence energy in joules, [state * nSymbols + symbol]
+   */
+  HistoryEnergyEvent(const std::string name, const unsigned int nStates_,
+                     const unsigned int nSymbols_,
+                     const std::vector<unsigned int> &next_,
+                     const std::vector<double> &energy_)
+      : PowerModelEventBase(name), nStates(nStates_), nSymbols(nSymbols_),
+        energy(energy_) {
+    if (nStates == 0 || nStates > maxStates || nSymbols == 0 ||
+        next_.size() != nStates * nSymbols ||
+        energy_.size() != nStates * nSymbols) {
+      throw std::invalid_argument(fmt::format(
+          "HistoryEnergyEvent::HistoryEnergyEvent '{:s}': tables must have "
+          "nStates * nSymbols entries, with 0 < nStates <= {:d}",
+          name, maxStates));
+    }
+    for (const auto s : next_) {
+      if (s >= nStates) {
+        throw std::invalid_argument(fmt::format(
+            "HistoryEnergyEvent::HistoryEnergyEvent '{:s}': next state {:d} "
+            "out of range",
+            name, s));
+      }
+      next.push_back(static_cast<uint8_t>(s));
+    }
+  }
+
+  /**
+   * @brief lastSymbol create an event whose energy depends on whether its
+   * symbol equals the previous occurrence's, e.g. with the row index (modulo
+   * nSymbols) as symbol for row-buffer hits and misses.
+   * @param name name of the event
+   * @param nSymbols number of symbols
+   * @param hitEnergy energy when the symbol repeats [J]
+   * @param missEnergy energy when the symbol changes [J]
+   */
+  static HistoryEnergyEvent lastSymbol(const std::string name,
+                                       const unsigned int nSymbols,
+                                       const double hitEnergy,
+                                       const double missEnergy) {
+    std::vector<unsigned int> next(nSymbols * nSymbols);
+    std::vector<double> energy(nSymbols * nSymbols);
+    for (unsigned int s = 0; s < nSymbols; ++s) {
+      for (unsigned int x = 0; x < nSymbols; ++x) {
+        next[s * nSymbols + x] = x;
+        energy[s * nSymbols + x] = s == x ? hitEnergy : missEnergy;
+      }
+    }
+    return HistoryEnergyEvent(name, nSymbols, nSymbols, next, energy);
+  }
+
+  virtual double calculateEnergy([
+      [maybe_unused]] const double supplyVoltage) const override {
+    return energy[0];
+  }
+
+  virtual std::string toString() const override {
+    return fmt::format(
+        FMT_STRING("<HistoryEnergyEvent> {:s}: {:d} states, {:d} symbols"),
+        name, nStates, nSymbols);
+  }
+
+  /* Public constants */
+  const unsigned int nStates;
+  const unsigned int nSymbols;
+  std::vector<uint8_t> next;
+  const std::vector<double> energy;
+};
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "PowerModelChannelIf.hpp"
+#include "PowerModelEventBase.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <systemc>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief InstructionEnergyModel instruction-level energy front-end for
+ * instruction set simulators.
+ *
+ * Each instruction class (e.g. ALU, multiply, load, store, branch) is a power
+ * model event, registered with the channel under this module's name. Rather
+ * than reporting every retired instruction, the ISS reports whole basic
+ * blocks: the first execution of a block classifies its instructions once
+ * and caches the block's class histogram, later executions only increment
+ * the block's execution count. flush() multiplies the histograms of the
+ * executed blocks by their counts and reports the class counts in one batch.
+ *
+ * Operand-dependent effects can be added with correction events, counted
+ * with correct() and reported in the same batch.
+ */
+class InstructionEnergyModel : public sc_core::sc_module {
+ public:
+  sc_core::sc_port<PowerModelChannelOutIf> powerModelPort{"powerModelPort"};
+
+  //! Constructor
+  explicit InstructionEnergyModel(const sc_core::sc_module_name name)
+      : sc_core::sc_module(name) {}
+
+  /**
+   * @brief addClass add an instruction class. Must be called during
+   * elaboration.
+   * @param event energy of one instruction of the class
+   * @retval class id
+   */
+  unsigned int addClass(std::shared_ptr<PowerModelEventBase> event) {
+    m_classEvents.push_back(std::move(event));
+    return m_classEvents.size() - 1;
+  }
+
+  /**
+   * @brief addCorrection add an operand-dependent correction event, e.g.
+   * energy per toggled operand bit. Must be called during elaboration.
+   * @param event energy of one unit of correction
+   * @retval correction id
+   */
+  unsigned int addCorrection(std::shared_ptr<PowerModelEventBase> event) {
+    m_correctionEvents.push_back(std::move(event));
+    return m_correctionEvents.size() - 1;
+  }
+
+  virtual void end_of_elaboration() override {
+    m_nClasses = m_classEvents.size();
+    m_eventIds.clear();
+    for (const auto &e : m_classEvents) {
+      m_eventIds.push_back(powerModelPort->registerEvent(name(), e));
+    }
+    for (const auto &e : m_correctionEvents) {
+      m_eventIds.push_back(powerModelPort->registerEvent(name(), e));
+    }
+    m_counts.assign(m_eventIds.size(), 0);
+  }
+
+  /**
+   * @brief executeBlock count one execution of the basic block starting at
+   * pc. On the block's first execution, classify(i) is called for each of
+   * its instructions and must return the class id of the i-th instruction.
+   * @param pc address of the block's first instruction
+   * @param nInstructions number of instructions in the block
+   * @param classify callable, unsigned int(unsigned int i)
+   */
+  template <typename Classify>
+  void executeBlock(const uint64_t pc, const unsigned int nInstructions,
+                    Classify classify) {
+    const auto it = m_blockIndex.find(pc);
+    unsigned int id;
+    if (it != m_blockIndex.end()) {
+      id = it->second;
+    } else {
+      id = addBlock(pc, nInstructions, classify);
+    }
+    auto &b = m_blocks[id];
+    if (b.executions++ == 0) {
+      m_executedBlocks.push_back(id);
+    }
+  }
+
+  /**
+   * @brief correct count n units of a correction.
+   * @param correctionId id as obtained from addCorrection
+   */
+  void correct(const unsigned int correctionId, const unsigned int n = 1) {
+    m_counts[m_nClasses + correctionId] += n;
+  }
+
+  /**
+   * @brief flush report the instructions of all blocks executed since the
+   * last flush, and the corrections, in one batch. Call at quantum
+   * boundaries.
+   */
+  void flush() {
+    for (const auto id : m_executedBlocks) {
+      auto &b = m_blocks[id];
+      for (unsigned int i = b.offset; i < b.offset + b.size; ++i) {
+        m_counts[m_histograms[i].classId] +=
+            uint64_t(m_histograms[i].count) * b.executions;
+      }
+      m_instructionCount += uint64_t(b.instructions) * b.executions;
+      b.executions = 0;
+    }
+    m_executedBlocks.clear();
+
+    // Counts above what PowerModelEventCount holds are split over entries
+    const uint64_t maxCount = std::numeric_limits<unsigned int>::max();
+    m_batch.clear();
+    for (unsigned int i = 0; i < m_counts.size(); ++i) {
+      while (m_counts[i] != 0) {
+        const auto n =
+            static_cast<unsigned int>(std::min(m_counts[i], maxCount));
+        m_batch.push_back({m_eventIds[i], n});
+        m_counts[i] -= n;
+      }
+    }
+    if (!m_batch.empty()) {
+      powerModelPort->reportEvents(m_batch);
+    }
+  }
+
+  /**
+   * @brief invalidateBlocks flush, then drop all cached blocks, e.g. after
+   * self-modifying code or a code cache flush in the ISS.
+   */
+  void invalidateBlocks() {
+    flush();
+    m_blocks.clear();
+    m_blockIndex.clear();
+    m_histograms.clear();
+  }
+
+  //! Number of instructions reported so far
+  uint64_t getInstructionCount() const { return m_instructionCount; }
+
+  //! Number of cached blocks
+  unsigned int getBlockCount() const { return m_blocks.size(); }
+
+ private:
+  //! Number of instructions of one class in a block
+  struct ClassCount {
+    unsigned int classId;
+    unsigned int count;
+  };
+
+  //! Cached block, its histogram is m_histograms[offset, offset + size)
+  struct Block {
+    unsigned int offset;
+    unsigned int size;
+    unsigned int instructions;
+    //! Executions since the last flush
+    unsigned int executions;
+  };
+
+  template <typename Classify>
+  unsigned int addBlock(const uint64_t pc, const unsigned int nInstructions,
+                        Classify &classify) {
+    // Dense histogram over classes, then compacted to the non-zero entries
+    m_scratch.assign(m_nClasses, 0);
+    for (unsigned int i = 0; i < nInstructions; ++i) {
+      const unsigned int c = classify(i);
+      sc_assert(c < m_nClasses);
+      m_scratch[c]++;
+    }
+    Block b{static_cast<unsigned int>(m_histograms.size()), 0, nInstructions,
+            0};
+    for (unsigned int c = 0; c < m_nClasses; ++c) {
+      if (m_scratch[c] != 0) {
+        m_histograms.push_back({c, m_scratch[c]});
+        b.size++;
+      }
+    }
+    const unsigned int id = m_blocks.size();
+    m_blocks.push_back(b);
+    m_blockIndex.emplace(pc, id);
+    return id;
+  }
+
+  std::vector<std::shared_ptr<PowerModelEventBase>> m_classEvents;
+  std::vector<std::shared_ptr<PowerModelEventBase>> m_correctionEvents;
+  unsigned int m_nClasses = 0;
+
+  //! Channel event ids of the classes, followed by those of the corrections
+  std::vector<unsigned int> m_eventIds;
+
+  std::vector<Block> m_blocks;
+  std::unordered_map<uint64_t, unsigned int> m_blockIndex;
+  std::vector<ClassCount> m_histograms;
+  std::vector<unsigned int> m_scratch;
+
+  //! Blocks with executions since the last flush
+  std::vector<unsigned int> m_executedBlocks;
+
+  //! Pending counts, indexed like m_eventIds
+  std::vector<uint64_t> m_counts;
+
+  uint64_t m_instructionCount = 0;
+
+  //! Reused batch buffer
+  std::vector<PowerModelEventCount> m_batch;
+};
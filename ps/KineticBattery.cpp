@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/KineticBattery.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+#include <systemc>
+
+using namespace sc_core;
+
+namespace {
+const double inf = std::numeric_limits<double>::infinity();
+} // namespace
+
+KineticBattery::KineticBattery(const sc_module_name name, const double capacity,
+                               const double c, const double k,
+                               const double vFull, const double vEmpty,
+                               const double resistance, const double initialSoc)
+    : sc_module(name), m_capacity(capacity), m_c(c),
+      m_kPrime(k / (c * (1.0 - c))), m_vFull(vFull), m_vEmpty(vEmpty),
+      m_resistance(resistance), m_y1(c * initialSoc * capacity),
+      m_y2((1.0 - c) * initialSoc * capacity) {
+  if (!(capacity > 0.0) || !(c > 0.0 && c < 1.0) || !(k > 0.0) ||
+      initialSoc < 0.0 || initialSoc > 1.0) {
+    throw std::invalid_argument(fmt::format(
+        "KineticBattery::KineticBattery invalid parameters capacity={}, "
+        "c={}, k={}, initialSoc={}",
+        capacity, c, k, initialSoc));
+  }
+  m_depleted = m_y1 <= 0.0;
+  m_lastVoltage = voltage(m_y1);
+  SC_HAS_PROCESS(KineticBattery);
+  SC_METHOD(process);
+  sensitive << i_load << m_wakeupEvent;
+}
+
+int KineticBattery::addThreshold(const double soc) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "KineticBattery::addThreshold thresholds can not be added after "
+        "simulation has started.");
+  }
+  m_thresholds.push_back(soc);
+  m_thresholdEvents.emplace_back(new sc_event());
+  return m_thresholds.size() - 1;
+}
+
+const sc_event &
+KineticBattery::thresholdEvent(const unsigned int thresholdId) const {
+  sc_assert(thresholdId < m_thresholdEvents.size());
+  return *m_thresholdEvents[thresholdId];
+}
+
+double KineticBattery::getStateOfCharge() const {
+  double y1, y2;
+  chargeAfter((sc_time_stamp() - m_t0).to_seconds(), y1, y2);
+  return (y1 + y2) / m_capacity;
+}
+
+double KineticBattery::getAvailableCharge() const {
+  double y1, y2;
+  chargeAfter((sc_time_stamp() - m_t0).to_seconds(), y1, y2);
+  return y1;
+}
+
+double KineticBattery::getVoltage() const {
+  double y1, y2;
+  chargeAfter((sc_time_stamp() - m_t0).to_seconds(), y1, y2);
+  return voltage(y1);
+}
+
+double KineticBattery::consume(const sc_time &time, const double staticCurrent,
+                               const double dynamicEnergy) {
+  advance();
+  const double dt = (time - m_lastConsumeTime).to_seconds();
+  m_lastConsumeTime = time;
+  m_loadCurrent =
+      staticCurrent + (dt > 0.0 && m_lastVoltage > 0.0
+                           ? dynamicEnergy / (m_lastVoltage * dt)
+                           : 0.0);
+  schedule();
+  m_lastVoltage = voltage(m_y1);
+  return m_lastVoltage;
+}
+
+void KineticBattery::process() {
+  advance();
+  if (i_load.size() > 0) {
+    m_loadCurrent = i_load->read();
+  }
+  if (v_out.size() > 0) {
+    v_out->write(voltage(m_y1));
+  }
+  schedule();
+}
+
+void KineticBattery::advance() {
+  const auto now = sc_time_stamp();
+  if (m_nextValid && now >= m_nextTime) {
+    chargeAfter((m_nextTime - m_t0).to_seconds(), m_y1, m_y2);
+    m_nextValid = false;
+    if (m_nextBreakpoint < 0) {
+      // Snap to empty, the battery can't supply the load any more
+      m_y1 = 0.0;
+      m_depleted = true;
+      m_emptyEvent.notify(SC_ZERO_TIME);
+    } else {
+      // Snap to the threshold, so it isn't scheduled again
+      m_y2 = m_thresholds[m_nextBreakpoint] * m_capacity - m_y1;
+      m_thresholdEvents[m_nextBreakpoint]->notify(SC_ZERO_TIME);
+    }
+    m_t0 = m_nextTime;
+  }
+  if (now > m_t0) {
+    chargeAfter((now - m_t0).to_seconds(), m_y1, m_y2);
+  }
+  m_t0 = now;
+}
+
+void KineticBattery::chargeAfter(const double dt, double &y1,
+                                 double &y2) const {
+  const double i = m_depleted ? 0.0 : m_loadCurrent;
+  if (dt <= 0.0 || m_depleted) {
+    y1 = m_y1;
+    y2 = m_y2;
+    return;
+  }
+  const double y0 = m_y1 + m_y2;
+  const double alpha = m_c * y0 - i * (1.0 - m_c) / m_kPrime;
+  const double beta = m_y1 - alpha;
+  y1 = alpha + beta * std::exp(-m_kPrime * dt) - i * m_c * dt;
+  y2 = y0 - i * dt - y1;
+}
+
+double KineticBattery::timeToEmpty() const {
+  const double i = m_loadCurrent;
+  if (m_depleted || i <= 0.0) {
+    return inf;
+  }
+  // f(t) = alpha + beta e^(-k't) - gamma t has exactly one root for t > 0,
+  // bracketed by [0, (alpha + max(beta, 0)) / gamma]
+  const double y0 = m_y1 + m_y2;
+  const double alpha = m_c * y0 - i * (1.0 - m_c) / m_kPrime;
+  const double beta = m_y1 - alpha;
+  const double gamma = i * m_c;
+  double lo = 0.0;
+  double hi = (alpha + std::max(beta, 0.0)) / gamma;
+  double t = std::min(hi, m_y1 / i);
+  for (int n = 0; n < 100; ++n) {
+    const double e = std::exp(-m_kPrime * t);
+    const double f = alpha + beta * e - gamma * t;
+    if (f > 0.0) {
+      lo = t;
+    } else {
+      hi = t;
+    }
+    const double df = -m_kPrime * beta * e - gamma;
+    double next = df < 0.0 ? t - f / df : 0.5 * (lo + hi);
+    if (!(next > lo && next < hi)) {
+      next = 0.5 * (lo + hi);
+    }
+    if (std::abs(next - t) <= 1e-12 * t) {
+      return hi;
+    }
+    t = next;
+  }
+  return hi;
+}
+
+double KineticBattery::voltage(const double y1) const {
+  if (m_depleted) {
+    return 0.0;
+  }
+  const double v = m_vEmpty + (m_vFull - m_vEmpty) * y1 / (m_c * m_capacity) -
+                   m_resistance * m_loadCurrent;
+  return std::max(v, 0.0);
+}
+
+void KineticBattery::schedule() {
+  m_wakeupEvent.cancel();
+  m_nextValid = false;
+  if (m_depleted || m_loadCurrent == 0.0) {
+    return;
+  }
+
+  // Total charge changes linearly, so threshold crossings are exact
+  const double soc = (m_y1 + m_y2) / m_capacity;
+  double dt = timeToEmpty();
+  int breakpoint = -1;
+  for (unsigned int n = 0; n < m_thresholds.size(); ++n) {
+    const double t = (soc - m_thresholds[n]) * m_capacity / m_loadCurrent;
+    if (t > 0.0 && t < dt) {
+      dt = t;
+      breakpoint = n;
+    }
+  }
+  if (!std::isfinite(dt)) {
+    return;
+  }
+  m_nextBreakpoint = breakpoint;
+  m_nextTime = m_t0 + sc_time::from_seconds(dt);
+  m_nextValid = true;
+  m_wakeupEvent.notify(m_nextTime - sc_time_stamp());
+}
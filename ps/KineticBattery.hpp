@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "PowerModelConsumerIf.hpp"
+
+#include <memory>
+#include <systemc>
+#include <vector>
+
+/**
+ * @brief KineticBattery kinetic battery model (KiBaM) discharged by a load
+ * current, e.g. the output of a PowerModelBridge.
+ *
+ * The charge is split into an available well y1 (fraction c of the capacity)
+ * and a bound well y2, connected by a valve with rate constant k:
+ *
+ *   dy1/dt = -i + k (h2 - h1),  dy2/dt = -k (h2 - h1),
+ *   h1 = y1 / c,  h2 = y2 / (1 - c)
+ *
+ * For a constant load current this has the closed-form solution
+ *
+ *   y1(t) = alpha + beta exp(-k' t) - i c t,   y2(t) = y1(0) + y2(0) - i t - y1(t)
+ *
+ * with k' = k / (c (1 - c)), alpha = c y0 - i (1 - c) / k' and
+ * beta = y1(0) - alpha. The module evaluates it only when the load changes
+ * and wakes up exactly at the next breakpoint: a state-of-charge threshold
+ * (reached linearly) or the available well running empty (found by a
+ * bracketed Newton iteration). This makes long, mostly idle, simulations
+ * cheap.
+ *
+ * The terminal voltage is vEmpty + (vFull - vEmpty) h1 / capacity - R i.
+ * When the available well runs empty, the battery is depleted: emptyEvent is
+ * triggered and the voltage drops to 0 for the rest of the simulation.
+ *
+ * The load can be driven either through i_load, or by coupling the battery
+ * directly to a bridge as its PowerModelConsumerIf.
+ */
+class KineticBattery : public sc_core::sc_module, public PowerModelConsumerIf {
+ public:
+  sc_core::sc_port<sc_core::sc_signal_in_if<double>, 1,
+                   sc_core::SC_ZERO_OR_MORE_BOUND>
+      i_load{"i_load"};
+  sc_core::sc_port<sc_core::sc_signal_inout_if<double>, 1,
+                   sc_core::SC_ZERO_OR_MORE_BOUND>
+      v_out{"v_out"};
+
+  /**
+   * @brief Constructor
+   * @param name module name
+   * @param capacity battery capacity [Coulomb]
+   * @param c fraction of the capacity in the available well, 0 < c < 1
+   * @param k valve rate constant [1/s]
+   * @param vFull open-circuit voltage when full [V]
+   * @param vEmpty open-circuit voltage when empty [V]
+   * @param resistance internal resistance [Ohm]
+   * @param initialSoc initial state of charge, wells in equilibrium
+   */
+  KineticBattery(const sc_core::sc_module_name name, const double capacity,
+                 const double c, const double k, const double vFull,
+                 const double vEmpty, const double resistance = 0.0,
+                 const double initialSoc = 1.0);
+
+  /**
+   * @brief addThreshold register a state-of-charge threshold. The threshold's
+   * event triggers whenever the state of charge crosses it. Thresholds must be
+   * registered before simulation starts.
+   * @param soc state of charge, 0..1
+   * @retval threshold id
+   */
+  int addThreshold(const double soc);
+
+  //! Event of a registered threshold
+  const sc_core::sc_event &thresholdEvent(const unsigned int thresholdId) const;
+
+  //! Event triggered when the battery is depleted
+  const sc_core::sc_event &emptyEvent() const { return m_emptyEvent; }
+
+  //! Total remaining charge as a fraction of the capacity
+  double getStateOfCharge() const;
+
+  //! Charge in the available well [Coulomb]
+  double getAvailableCharge() const;
+
+  //! Terminal voltage at the current simulation time
+  double getVoltage() const;
+
+  //! Whether the available well has run empty
+  bool isDepleted() const { return m_depleted; }
+
+  /**
+   * @brief consume set the load from a bridge's static current and event
+   * energy. See PowerModelConsumerIf.
+   * @retval terminal voltage
+   */
+  virtual double consume(const sc_core::sc_time &time,
+                         const double staticCurrent,
+                         const double dynamicEnergy) override;
+
+  const double m_capacity;   // [Coulomb]
+  const double m_c;          // [-]
+  const double m_kPrime;     // [1/s]
+  const double m_vFull;      // [Volt]
+  const double m_vEmpty;     // [Volt]
+  const double m_resistance; // [Ohm]
+
+ private:
+  //! SC_METHOD, triggered by load current changes and breakpoint wakeups
+  void process();
+
+  //! Move the segment start to the current simulation time
+  void advance();
+
+  //! Well contents dt seconds after the segment start
+  void chargeAfter(const double dt, double &y1, double &y2) const;
+
+  //! Time from the segment start until the available well is empty
+  double timeToEmpty() const;
+
+  //! Terminal voltage for a given available charge at the present load
+  double voltage(const double y1) const;
+
+  //! Schedule the wakeup for the next breakpoint
+  void schedule();
+
+  double m_loadCurrent = 0.0; // [Ampere]
+  bool m_depleted = false;
+
+  //! Time of the last call to consume, and the voltage returned then
+  sc_core::sc_time m_lastConsumeTime{sc_core::SC_ZERO_TIME};
+  double m_lastVoltage;
+
+  //! Segment start
+  double m_y1;
+  double m_y2;
+  sc_core::sc_time m_t0{sc_core::SC_ZERO_TIME};
+
+  //! Next breakpoint: threshold index, or -1 for empty
+  sc_core::sc_time m_nextTime{sc_core::SC_ZERO_TIME};
+  int m_nextBreakpoint = 0;
+  bool m_nextValid = false;
+
+  std::vector<double> m_thresholds;
+  std::vector<std::unique_ptr<sc_core::sc_event>> m_thresholdEvents;
+
+  sc_core::sc_event m_emptyEvent{"emptyEvent"};
+  sc_core::sc_event m_wakeupEvent{"wakeupEvent"};
+};
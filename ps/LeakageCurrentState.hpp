@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include "PowerModelStateBase.hpp"
+
+/**
+ * Power model state for leakage currents that grow exponentially with
+ * temperature:
+ *
+ *   i(T) = nominalCurrent * 2^((T - nominalTemperature) / doublingInterval)
+ *
+ * The temperature is set externally, typically by a ThermalModel. It is
+ * rounded to buckets of bucketWidth, and the exponential is evaluated once per
+ * bucket and cached, so calculateCurrent is as cheap as for a constant state.
+ */
+class LeakageCurrentState : public PowerModelStateBase {
+ public:
+  /**
+   * @brief Constructor
+   * @param name name of this state
+   * @param nominalCurrent_ current at the nominal temperature [A]
+   * @param nominalTemperature_ nominal temperature [deg C]
+   * @param doublingInterval_ temperature increase that doubles the current
+   * [K], must be positive
+   * @param bucketWidth_ temperature resolution [K], must be positive
+   */
+  LeakageCurrentState(const std::string name, const double nominalCurrent_,
+                      const double nominalTemperature_ = 25.0,
+                      const double doublingInterval_ = 10.0,
+                      const double bucketWidth_ = 0.25)
+      : PowerModelStateBase(name), nominalCurrent(nominalCurrent_),
+        nominalTemperature(nominalTemperature_),
+        doublingInterval(doublingInterval_), bucketWidth(bucketWidth_) {
+    // Negated to also reject NaN
+    if (!(doublingInterval > 0.0) || !(bucketWidth > 0.0)) {
+      throw std::invalid_argument(fmt::format(
+          "LeakageCurrentState::LeakageCurrentState {:s}: doubling interval "
+          "({:g} K) and bucket width ({:g} K) must be positive",
+          name, doublingInterval, bucketWidth));
+    }
+    setTemperature(nominalTemperature);
+  }
+
+  virtual double calculateCurrent([
+      [maybe_unused]] const double supplyVoltage) const override {
+    return m_current;
+  }
+
+  /**
+   * @brief setTemperature set the temperature the leakage current is
+   * evaluated at.
+   * @param t temperature [deg C]
+   */
+  void setTemperature(const double t) {
+    const long bucket = std::lround((t - nominalTemperature) / bucketWidth);
+    if (bucket == m_bucket) {
+      return;
+    }
+    m_bucket = bucket;
+    const auto it = m_factors.find(bucket);
+    const double factor =
+        it != m_factors.end()
+            ? it->second
+            : (m_factors[bucket] =
+                   std::exp2(bucket * bucketWidth / doublingInterval));
+    m_current = nominalCurrent * factor;
+  }
+
+  //! Temperature of the present bucket [deg C]
+  double getTemperature() const {
+    return nominalTemperature + m_bucket * bucketWidth;
+  }
+
+  virtual std::string toString() const override {
+    return fmt::format(
+        FMT_STRING("<LeakageCurrentState> {:s}: current={:.6} nA @ {:.1f} C, "
+                   "x2 per {:.1f} K"),
+        name, nominalCurrent * 1e9, nominalTemperature, doublingInterval);
+  }
+
+  /* Public constants */
+  const double nominalCurrent;     // [Ampere]
+  const double nominalTemperature; // [Celsius]
+  const double doublingInterval;   // [Kelvin]
+  const double bucketWidth;        // [Kelvin]
+
+ private:
+  //! Temperature bucket, relative to the nominal temperature
+  long m_bucket = std::numeric_limits<long>::min();
+  double m_current = 0.0;
+  //! Cached 2^(...) factor per bucket
+  std::unordered_map<long, double> m_factors;
+};
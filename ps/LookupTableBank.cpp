@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/LookupTableBank.hpp"
+#include <algorithm>
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+
+namespace {
+bool strictlyIncreasing(const std::vector<double> &v) {
+  return std::adjacent_find(v.begin(), v.end(), [](double a, double b) {
+           return a >= b;
+         }) == v.end();
+}
+} // namespace
+
+LookupTableBank::LookupTableBank(const std::vector<double> &voltages,
+                                 const std::vector<double> &temperatures)
+    : m_voltages(voltages), m_temperatures(temperatures) {
+  if (voltages.empty() || !strictlyIncreasing(voltages) ||
+      !strictlyIncreasing(temperatures)) {
+    throw std::invalid_argument(
+        "LookupTableBank::LookupTableBank grids must be non-empty and "
+        "strictly increasing");
+  }
+}
+
+unsigned int LookupTableBank::addTable(const std::vector<double> &values) {
+  const size_t points =
+      m_voltages.size() * std::max<size_t>(1, m_temperatures.size());
+  if (values.size() != points) {
+    throw std::invalid_argument(fmt::format(
+        "LookupTableBank::addTable expected {:d} values, got {:d}", points,
+        values.size()));
+  }
+  m_tables.push_back(values);
+
+  // Re-interleave, tables are only added during elaboration
+  const size_t n = m_tables.size();
+  m_values.assign(points * n, 0.0);
+  for (size_t t = 0; t < n; ++t) {
+    for (size_t p = 0; p < points; ++p) {
+      m_values[p * n + t] = m_tables[t][p];
+    }
+  }
+  m_cache.resize(n);
+  update();
+  return n - 1;
+}
+
+void LookupTableBank::locate(const std::vector<double> &grid, const double x,
+                             unsigned int &i, double &w) {
+  if (grid.size() == 1 || !(x > grid.front())) {
+    i = 0;
+    w = 0.0;
+  } else if (x >= grid.back()) {
+    i = grid.size() - 2;
+    w = 1.0;
+  } else {
+    i = std::upper_bound(grid.begin(), grid.end(), x) - grid.begin() - 1;
+    w = (x - grid[i]) / (grid[i + 1] - grid[i]);
+  }
+}
+
+void LookupTableBank::update() {
+  const size_t n = m_tables.size();
+  if (n == 0) {
+    return;
+  }
+
+  unsigned int iv;
+  double wv;
+  locate(m_voltages, m_voltage, iv, wv);
+  const unsigned int iv1 = m_voltages.size() > 1 ? iv + 1 : iv;
+
+  if (m_temperatures.empty()) {
+    const double *a = &m_values[iv * n];
+    const double *b = &m_values[iv1 * n];
+    for (size_t t = 0; t < n; ++t) {
+      m_cache[t] = a[t] + wv * (b[t] - a[t]);
+    }
+    return;
+  }
+
+  unsigned int it;
+  double wt;
+  locate(m_temperatures, m_temperature, it, wt);
+  const unsigned int it1 = m_temperatures.size() > 1 ? it + 1 : it;
+  const size_t nt = m_temperatures.size();
+  const double *a = &m_values[(iv * nt + it) * n];
+  const double *b = &m_values[(iv * nt + it1) * n];
+  const double *c = &m_values[(iv1 * nt + it) * n];
+  const double *d = &m_values[(iv1 * nt + it1) * n];
+  for (size_t t = 0; t < n; ++t) {
+    const double lo = a[t] + wt * (b[t] - a[t]);
+    const double hi = c[t] + wt * (d[t] - c[t]);
+    m_cache[t] = lo + wv * (hi - lo);
+  }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+/**
+ * @brief LookupTableBank a set of characterization tables sharing the same
+ * supply voltage (and optionally temperature) grid.
+ *
+ * All tables in a bank are interpolated together whenever the voltage or
+ * temperature changes, in one pass over values stored grid-point-major, and
+ * the results are cached until the next change. Models built on a bank
+ * (LookupTableEnergyEvent, LookupTableCurrentState) then only read their
+ * cached value, which is as cheap as a constant model.
+ *
+ * Interpolation is (bi)linear. Values outside the grid are clamped to the
+ * nearest grid point.
+ */
+class LookupTableBank {
+ public:
+  /**
+   * @brief Constructor
+   * @param voltages strictly increasing supply voltage grid in volts
+   * @param temperatures strictly increasing temperature grid in degrees
+   * Celsius, or empty for voltage-only tables
+   */
+  LookupTableBank(const std::vector<double> &voltages,
+                  const std::vector<double> &temperatures = {});
+
+  /**
+   * @brief addTable add a table to the bank.
+   * @param values one value per grid point, voltage-major, i.e.
+   * values[iv * temperatures.size() + it] for 2-D tables.
+   * @retval index of the table in the bank
+   */
+  unsigned int addTable(const std::vector<double> &values);
+
+  /**
+   * @brief setVoltage re-interpolate all tables at a new supply voltage.
+   * Does nothing if the voltage is unchanged.
+   */
+  void setVoltage(const double v) {
+    if (v != m_voltage) {
+      m_voltage = v;
+      update();
+    }
+  }
+
+  /**
+   * @brief setTemperature re-interpolate all tables at a new temperature.
+   * Does nothing if the temperature is unchanged.
+   */
+  void setTemperature(const double t) {
+    if (t != m_temperature) {
+      m_temperature = t;
+      update();
+    }
+  }
+
+  /**
+   * @brief value get the interpolated value of a table at a given voltage,
+   * re-interpolating the bank only if the voltage has changed.
+   */
+  double value(const unsigned int table, const double v) {
+    setVoltage(v);
+    return m_cache[table];
+  }
+
+  //! Number of tables in the bank
+  unsigned int size() const { return m_tables.size(); }
+
+  double voltage() const { return m_voltage; }
+  double temperature() const { return m_temperature; }
+
+ private:
+  //! Interpolate all tables at the current voltage & temperature
+  void update();
+
+  /**
+   * @brief locate find the grid segment containing x.
+   * @param grid grid to search
+   * @param i index of the lower grid point
+   * @param w weight of the upper grid point
+   */
+  static void locate(const std::vector<double> &grid, const double x,
+                     unsigned int &i, double &w);
+
+  const std::vector<double> m_voltages;
+  const std::vector<double> m_temperatures;
+
+  //! Tables as added, one vector per table
+  std::vector<std::vector<double>> m_tables;
+
+  //! Grid-point-major copy of m_tables: m_values[point * size() + table]
+  std::vector<double> m_values;
+
+  //! Interpolated value of each table
+  std::vector<double> m_cache;
+
+  double m_voltage = std::numeric_limits<double>::quiet_NaN();
+  double m_temperature = 25.0;
+};
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "LookupTableBank.hpp"
+#include "PowerModelStateBase.hpp"
+
+/**
+ * Power model state whose current is interpolated from a voltage (and
+ * optionally temperature) characterization table. See LookupTableEnergyEvent.
+ */
+class LookupTableCurrentState : public PowerModelStateBase {
+ public:
+  /**
+   * @brief Constructor
+   * @param name name of this state
+   * @param bank_ bank holding the grid, shared with other table models
+   * @param currents current per grid point in amperes, see
+   * LookupTableBank::addTable
+   */
+  LookupTableCurrentState(const std::string name,
+                          std::shared_ptr<LookupTableBank> bank_,
+                          const std::vector<double> &currents)
+      : PowerModelStateBase(name), bank(std::move(bank_)),
+        table(bank->addTable(currents)) {}
+
+  virtual double calculateCurrent(const double supplyVoltage) const override {
+    return bank->value(table, supplyVoltage);
+  }
+
+  virtual std::string toString() const override {
+    return fmt::format(
+        FMT_STRING("<LookupTableCurrentState> {:s}: table={:d}"), name, table);
+  }
+
+  /* Public constants */
+  const std::shared_ptr<LookupTableBank> bank;
+  const unsigned int table;
+};
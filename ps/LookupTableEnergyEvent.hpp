@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "LookupTableBank.hpp"
+#include "PowerModelEventBase.hpp"
+
+/**
+ * Power model event whose energy is interpolated from a voltage (and
+ * optionally temperature) characterization table. The table lives in a
+ * LookupTableBank, which may be shared by many models so that they are all
+ * re-interpolated in one pass when the supply voltage changes.
+ */
+class LookupTableEnergyEvent : public PowerModelEventBase {
+ public:
+  /**
+   * @brief Constructor
+   * @param name name of this event
+   * @param bank_ bank holding the grid, shared with other table models
+   * @param energies energy per grid point in joules, see
+   * LookupTableBank::addTable
+   */
+  LookupTableEnergyEvent(const std::string name,
+                         std::shared_ptr<LookupTableBank> bank_,
+                         const std::vector<double> &energies)
+      : PowerModelEventBase(name), bank(std::move(bank_)),
+        table(bank->addTable(energies)) {}
+
+  virtual double calculateEnergy(const double supplyVoltage) const override {
+    return bank->value(table, supplyVoltage);
+  }
+
+  virtual std::string toString() const override {
+    return fmt::format(
+        FMT_STRING("<LookupTableEnergyEvent> {:s}: table={:d}"), name, table);
+  }
+
+  /* Public constants */
+  const std::shared_ptr<LookupTableBank> bank;
+  const unsigned int table;
+};
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "PowerModelChannelIf.hpp"
+#include "PowerModelConsumerIf.hpp"
+
+#include <functional>
+#include <systemc>
+#include <vector>
+
+/**
+ * @brief MultiRailBridge bridge between any number of PowerModelChannels and
+ * their consumers, evaluated by a single process.
+ *
+ * Each channel bound to powerModelPorts is one rail. Every timestep, the
+ * bridge pops the event energy and reads the static current of all rails in
+ * one pass over contiguous per-rail arrays, and publishes the rail currents
+ * as an array, through an optional callback and through currentsUpdatedEvent.
+ * Rail voltages are set with setRailVoltage, which also forwards them to the
+ * rail's channel, or by a per-rail PowerModelConsumerIf set with
+ * setRailConsumer, which is called in the same pass.
+ *
+ * Unlike PowerModelBridge, this does not write the channels' event power log.
+ */
+SC_MODULE(MultiRailBridge) {
+  sc_core::sc_port<PowerModelChannelInIf, 0> powerModelPorts{
+      "powerModelPorts"};
+
+  //! Callback type, invoked once per timestep with the current of each rail
+  typedef std::function<void(const std::vector<double> &currents)>
+      CurrentsCallback;
+
+  MultiRailBridge(const sc_core::sc_module_name name,
+                  const sc_core::sc_time timestep)
+      : sc_core::sc_module(name), m_timestep(timestep) {
+    SC_HAS_PROCESS(MultiRailBridge);
+    SC_METHOD(process);
+  }
+
+  virtual void end_of_elaboration() override {
+    const int n = powerModelPorts.size();
+    m_channels.resize(n);
+    for (int i = 0; i < n; ++i) {
+      m_channels[i] = powerModelPorts[i];
+    }
+    m_voltages.resize(n, 0.0);
+    m_currents.resize(n, 0.0);
+    m_consumers.resize(n, nullptr);
+  }
+
+  /**
+   * @brief setRailVoltage set the supply voltage of a rail.
+   * @param rail index of the rail, in binding order
+   * @param v supply voltage in volts
+   */
+  void setRailVoltage(const unsigned int rail, const double v) {
+    sc_assert(rail < m_channels.size());
+    m_voltages[rail] = v;
+    m_channels[rail]->setSupplyVoltage(v);
+  }
+
+  /**
+   * @brief setRailConsumer couple a consumer directly to a rail. The consumer
+   * is called every timestep, and the voltage it returns is applied to the
+   * rail.
+   * @param rail index of the rail, in binding order
+   * @param consumer consumer, or nullptr to decouple
+   */
+  void setRailConsumer(const unsigned int rail,
+                       PowerModelConsumerIf *consumer) {
+    sc_assert(rail < m_consumers.size());
+    m_consumers[rail] = consumer;
+  }
+
+  //! Set a callback that receives the rail currents every timestep
+  void setCallback(CurrentsCallback callback) {
+    m_callback = std::move(callback);
+  }
+
+  //! Current of each rail in amperes, as of the last timestep
+  const std::vector<double> &currents() const { return m_currents; }
+
+  //! Event triggered after the rail currents have been updated
+  const sc_core::sc_event &currentsUpdatedEvent() const {
+    return m_updatedEvent;
+  }
+
+  void process() {
+    // Initialization run, currents are zero until the first timestep
+    if (!m_started) {
+      m_started = true;
+      next_trigger(m_timestep);
+      return;
+    }
+
+    const auto now = sc_core::sc_time_stamp();
+    const double ts = m_timestep.to_seconds();
+    const unsigned int n = m_channels.size();
+    for (unsigned int i = 0; i < n; ++i) {
+      if (m_consumers[i] != nullptr) {
+        const double staticCurrent = m_channels[i]->getStaticCurrent();
+        const double dynamicEnergy = m_channels[i]->popDynamicEnergy();
+        m_currents[i] =
+            m_voltages[i] > 0.0
+                ? staticCurrent + dynamicEnergy / (m_voltages[i] * ts)
+                : 0.0;
+        setRailVoltage(i, m_consumers[i]->consume(now, staticCurrent,
+                                                  dynamicEnergy));
+        continue;
+      }
+      const double v = m_voltages[i];
+      if (v <= 0.0) {
+        m_currents[i] = 0.0;
+        continue;
+      }
+      // Dynamic current = E/(v*ts)
+      m_currents[i] = m_channels[i]->getStaticCurrent() +
+                      m_channels[i]->popDynamicEnergy() / (v * ts);
+    }
+    if (m_callback) {
+      m_callback(m_currents);
+    }
+    m_updatedEvent.notify(sc_core::SC_ZERO_TIME);
+    next_trigger(m_timestep);
+  }
+
+  const sc_core::sc_time m_timestep;
+
+ private:
+  //! Per-rail state, indexed by rail
+  std::vector<PowerModelChannelInIf *> m_channels;
+  std::vector<double> m_voltages;
+  std::vector<double> m_currents;
+  std::vector<PowerModelConsumerIf *> m_consumers;
+
+  CurrentsCallback m_callback;
+  bool m_started = false;
+  sc_core::sc_event m_updatedEvent{"currentsUpdatedEvent"};
+};
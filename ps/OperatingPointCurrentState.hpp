@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OperatingPointTable.hpp"
+#include "PowerModelStateBase.hpp"
+
+/**
+ * Power model state with one precomputed current per DVFS operating point.
+ * See OperatingPointEnergyEvent.
+ */
+class OperatingPointCurrentState : public PowerModelStateBase {
+ public:
+  /**
+   * @brief Constructor
+   * @param name name of this state
+   * @param points_ operating point table, shared with other models
+   * @param currents current per operating point in amperes
+   */
+  OperatingPointCurrentState(const std::string name,
+                             std::shared_ptr<OperatingPointTable> points_,
+                             const std::vector<double> &currents)
+      : PowerModelStateBase(name), points(std::move(points_)),
+        table(points->addTable(currents)) {}
+
+  virtual double calculateCurrent([
+      [maybe_unused]] const double supplyVoltage) const override {
+    return points->value(table);
+  }
+
+  virtual std::string toString() const override {
+    return fmt::format(
+        FMT_STRING("<OperatingPointCurrentState> {:s}: table={:d}"), name,
+        table);
+  }
+
+  /* Public constants */
+  const std::shared_ptr<OperatingPointTable> points;
+  const unsigned int table;
+};
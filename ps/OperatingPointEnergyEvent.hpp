@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "OperatingPointTable.hpp"
+#include "PowerModelEventBase.hpp"
+
+/**
+ * Power model event with one precomputed energy per DVFS operating point. The
+ * energy follows the operating point selected with
+ * PowerModelChannel::setOperatingPoint, regardless of the supply voltage
+ * passed in.
+ */
+class OperatingPointEnergyEvent : public PowerModelEventBase {
+ public:
+  /**
+   * @brief Constructor
+   * @param name name of this event
+   * @param points_ operating point table, shared with other models
+   * @param energies energy per operating point in joules
+   */
+  OperatingPointEnergyEvent(const std::string name,
+                            std::shared_ptr<OperatingPointTable> points_,
+                            const std::vector<double> &energies)
+      : PowerModelEventBase(name), points(std::move(points_)),
+        table(points->addTable(energies)) {}
+
+  virtual double calculateEnergy([
+      [maybe_unused]] const double supplyVoltage) const override {
+    return points->value(table);
+  }
+
+  virtual std::string toString() const override {
+    return fmt::format(
+        FMT_STRING("<OperatingPointEnergyEvent> {:s}: table={:d}"), name,
+        table);
+  }
+
+  /* Public constants */
+  const std::shared_ptr<OperatingPointTable> points;
+  const unsigned int table;
+};
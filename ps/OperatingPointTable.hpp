@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief OperatingPointTable a set of tables with one precomputed value per
+ * DVFS operating point (supply voltage and clock frequency).
+ *
+ * Values are stored operating-point-major, so selecting an operating point
+ * only moves a pointer to that point's row; models built on the table
+ * (OperatingPointEnergyEvent, OperatingPointCurrentState) then read their
+ * value from the row. Operating points are selected through
+ * PowerModelChannel::setOperatingPoint.
+ */
+class OperatingPointTable {
+ public:
+  //! DVFS operating point
+  struct OperatingPoint {
+    double voltage;   // [Volt]
+    double frequency; // [Hertz]
+  };
+
+  /**
+   * @brief Constructor
+   * @param points operating points, the first one is selected initially
+   */
+  explicit OperatingPointTable(const std::vector<OperatingPoint> &points)
+      : m_points(points) {
+    if (m_points.empty()) {
+      throw std::invalid_argument(
+          "OperatingPointTable::OperatingPointTable no operating points");
+    }
+  }
+
+  /**
+   * @brief addTable add a table.
+   * @param values one value per operating point, in the order of points()
+   * @retval index of the table
+   */
+  unsigned int addTable(const std::vector<double> &values) {
+    if (values.size() != m_points.size()) {
+      throw std::invalid_argument(fmt::format(
+          FMT_STRING("OperatingPointTable::addTable expected {:d} values, got "
+                     "{:d}"),
+          m_points.size(), values.size()));
+    }
+    // Re-interleave, rows are operating points
+    const unsigned int n = m_nTables;
+    std::vector<double> rows(m_points.size() * (n + 1));
+    for (unsigned int p = 0; p < m_points.size(); ++p) {
+      for (unsigned int t = 0; t < n; ++t) {
+        rows[p * (n + 1) + t] = m_values[p * n + t];
+      }
+      rows[p * (n + 1) + n] = values[p];
+    }
+    m_values.swap(rows);
+    m_nTables++;
+    select(m_point);
+    return n;
+  }
+
+  //! Select an operating point
+  void select(const unsigned int point) {
+    if (point >= m_points.size()) {
+      throw std::invalid_argument(fmt::format(
+          FMT_STRING("OperatingPointTable::select no operating point {:d}"),
+          point));
+    }
+    m_point = point;
+    m_row = m_values.data() + point * m_nTables;
+  }
+
+  //! Value of a table at the selected operating point
+  double value(const unsigned int table) const { return m_row[table]; }
+
+  //! Selected operating point
+  unsigned int point() const { return m_point; }
+
+  const std::vector<OperatingPoint> &points() const { return m_points; }
+
+  //! Number of tables
+  unsigned int size() const { return m_nTables; }
+
+ private:
+  const std::vector<OperatingPoint> m_points;
+  unsigned int m_nTables = 0;
+
+  //! Values, m_values[point * m_nTables + table]
+  std::vector<double> m_values;
+
+  unsigned int m_point = 0;
+  const double *m_row = nullptr;
+};
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "PowerModelChannelIf.hpp"
+#include "PowerModelEventBase.hpp"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/passthrough_target_socket.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <vector>
+
+/**
+ * @brief PowerAnnotatingSocket TLM-2.0 passthrough that reports the
+ * transactions flowing through it as power model events.
+ *
+ * Insert it between an initiator and a target (or anywhere in a bus fabric):
+ * all transport, DMI and debug calls are forwarded unchanged in both
+ * directions. Each transaction is classified by command, burst length (in bus
+ * beats) and byte-enable density (the fraction of enabled byte lanes), and
+ * counted against one of the event classes added with addEventClass. Counts
+ * are reported to the channel in one batch per delta cycle. Transactions with
+ * a non-zero annotated delay, e.g. from temporally decoupled initiators, are
+ * reported at their local time offset instead, see
+ * PowerModelChannel::setTemporalDecoupling.
+ *
+ * If powerModelPort is left unbound, no events are registered and
+ * transactions are forwarded without being classified.
+ */
+template <unsigned int BUSWIDTH = 32>
+class PowerAnnotatingSocket : public sc_core::sc_module {
+ public:
+  typedef PowerAnnotatingSocket<BUSWIDTH> SC_CURRENT_USER_MODULE;
+
+  tlm_utils::passthrough_target_socket<PowerAnnotatingSocket, BUSWIDTH>
+      target_socket{"target_socket"};
+  tlm_utils::simple_initiator_socket<PowerAnnotatingSocket, BUSWIDTH>
+      initiator_socket{"initiator_socket"};
+  sc_core::sc_port<PowerModelChannelOutIf, 1, sc_core::SC_ZERO_OR_MORE_BOUND>
+      powerModelPort{"powerModelPort"};
+
+  //! Number of burst length buckets: 1, 2, 3-4, 5-8, ... beats
+  static const unsigned int nBurstBuckets = 8;
+
+  //! Number of byte-enable density buckets: up to 1/4, 2/4, 3/4 and 4/4 of
+  //! the byte lanes enabled
+  static const unsigned int nDensityBuckets = 4;
+
+  //! Constructor
+  explicit PowerAnnotatingSocket(const sc_core::sc_module_name name)
+      : sc_core::sc_module(name) {
+    target_socket.register_b_transport(this, &PowerAnnotatingSocket::b_transport);
+    target_socket.register_nb_transport_fw(
+        this, &PowerAnnotatingSocket::nb_transport_fw);
+    target_socket.register_get_direct_mem_ptr(
+        this, &PowerAnnotatingSocket::get_direct_mem_ptr);
+    target_socket.register_transport_dbg(
+        this, &PowerAnnotatingSocket::transport_dbg);
+    initiator_socket.register_nb_transport_bw(
+        this, &PowerAnnotatingSocket::nb_transport_bw);
+    initiator_socket.register_invalidate_direct_mem_ptr(
+        this, &PowerAnnotatingSocket::invalidate_direct_mem_ptr);
+
+    SC_METHOD(flush);
+    sensitive << m_flushEvent;
+    dont_initialize();
+  }
+
+  /**
+   * @brief addEventClass add an event class. Transactions are counted against
+   * the class with the smallest maxBeats that covers them, and among those
+   * the one with the smallest maxDensity that covers them. Transactions
+   * without byte enables have density 1. Must be called during elaboration.
+   * @param command tlm::TLM_READ_COMMAND or tlm::TLM_WRITE_COMMAND
+   * @param maxBeats longest burst covered, rounded up to a power of two
+   * @param maxDensity largest fraction of enabled byte lanes covered, in
+   * (0, 1], rounded up to a multiple of 1 / nDensityBuckets
+   * @param event event model, registered with the channel under this
+   * module's name
+   * @retval class id
+   */
+  unsigned int addEventClass(const tlm::tlm_command command,
+                             const unsigned int maxBeats,
+                             const double maxDensity,
+                             std::shared_ptr<PowerModelEventBase> event) {
+    sc_assert(command == tlm::TLM_READ_COMMAND ||
+              command == tlm::TLM_WRITE_COMMAND);
+    sc_assert(maxDensity > 0.0 && maxDensity <= 1.0);
+    const unsigned int density = static_cast<unsigned int>(
+        std::ceil(maxDensity * nDensityBuckets - 1e-9)) - 1;
+    m_classes.push_back({command, burstBucket(maxBeats), density,
+                         std::move(event)});
+    return m_classes.size() - 1;
+  }
+
+  virtual void end_of_elaboration() override {
+    m_enabled = powerModelPort.size() > 0;
+    if (!m_enabled) {
+      return;
+    }
+    m_eventIds.clear();
+    for (auto &c : m_classes) {
+      m_eventIds.push_back(powerModelPort->registerEvent(name(), c.event));
+    }
+    m_pending.assign(m_classes.size(), 0);
+
+    // Dense lookup table: [command][density bucket][burst bucket] -> class
+    for (unsigned int cmd = 0; cmd < 2; ++cmd) {
+      for (unsigned int d = 0; d < nDensityBuckets; ++d) {
+        for (unsigned int b = 0; b < nBurstBuckets; ++b) {
+          m_lookup[cmd][d][b] = findClass(cmd, d, b);
+        }
+      }
+    }
+  }
+
+ private:
+  struct EventClass {
+    tlm::tlm_command command;
+    unsigned int bucket;
+    unsigned int density;
+    std::shared_ptr<PowerModelEventBase> event;
+  };
+
+  static unsigned int burstBucket(unsigned int beats) {
+    unsigned int b = 0;
+    for (beats = beats > 0 ? beats - 1 : 0; beats > 0 && b + 1 < nBurstBuckets;
+         beats >>= 1) {
+      ++b;
+    }
+    return b;
+  }
+
+  //! Density bucket of n enabled out of total byte lanes
+  static unsigned int densityBucket(const unsigned int n,
+                                    const unsigned int total) {
+    const unsigned int d = (n * nDensityBuckets + total - 1) / total;
+    return d > 0 ? d - 1 : 0;
+  }
+
+  int findClass(const unsigned int cmd, const unsigned int density,
+                const unsigned int bucket) const {
+    int best = -1;
+    for (unsigned int i = 0; i < m_classes.size(); ++i) {
+      const auto &c = m_classes[i];
+      if (static_cast<unsigned int>(c.command) != cmd || c.bucket < bucket ||
+          c.density < density) {
+        continue;
+      }
+      if (best < 0 || c.bucket < m_classes[best].bucket ||
+          (c.bucket == m_classes[best].bucket &&
+           c.density < m_classes[best].density)) {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  //! Count a transaction, at local time offset delay, against its event class
+  void annotate(const tlm::tlm_generic_payload &trans,
+                const sc_core::sc_time &delay) {
+    const auto cmd = trans.get_command();
+    if (cmd == tlm::TLM_IGNORE_COMMAND) {
+      return;
+    }
+    const unsigned int beats = (trans.get_data_length() + BUSWIDTH / 8 - 1) /
+                               (BUSWIDTH / 8);
+    unsigned int density = nDensityBuckets - 1;
+    const auto be = trans.get_byte_enable_ptr();
+    const unsigned int beLength = trans.get_byte_enable_length();
+    if (be != nullptr && beLength > 0) {
+      unsigned int enabled = 0;
+      for (unsigned int i = 0; i < beLength; ++i) {
+        enabled += be[i] == TLM_BYTE_ENABLED;
+      }
+      density = densityBucket(enabled, beLength);
+    }
+    const int c = m_lookup[cmd][density][burstBucket(beats)];
+    if (c < 0) {
+      return;
+    }
+    if (delay != sc_core::SC_ZERO_TIME) {
+      // The channel holds it until simulation time reaches it
+      powerModelPort->reportEvent(m_eventIds[c], 1, delay);
+      return;
+    }
+    ++m_pending[c];
+    if (!m_flushPending) {
+      m_flushPending = true;
+      m_flushEvent.notify(sc_core::SC_ZERO_TIME);
+    }
+  }
+
+  //! Report the pending counts to the channel
+  void flush() {
+    for (unsigned int i = 0; i < m_pending.size(); ++i) {
+      if (m_pending[i] != 0) {
+        powerModelPort->reportEvent(m_eventIds[i], m_pending[i]);
+        m_pending[i] = 0;
+      }
+    }
+    m_flushPending = false;
+  }
+
+  // ------ Forward path ------
+  void b_transport(tlm::tlm_generic_payload &trans, sc_core::sc_time &delay) {
+    if (m_enabled) {
+      annotate(trans, delay);
+    }
+    initiator_socket->b_transport(trans, delay);
+  }
+
+  tlm::tlm_sync_enum nb_transport_fw(tlm::tlm_generic_payload &trans,
+                                     tlm::tlm_phase &phase,
+                                     sc_core::sc_time &delay) {
+    if (m_enabled && phase == tlm::BEGIN_REQ) {
+      annotate(trans, delay);
+    }
+    return initiator_socket->nb_transport_fw(trans, phase, delay);
+  }
+
+  bool get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
+                          tlm::tlm_dmi &dmi) {
+    return initiator_socket->get_direct_mem_ptr(trans, dmi);
+  }
+
+  unsigned int transport_dbg(tlm::tlm_generic_payload &trans) {
+    return initiator_socket->transport_dbg(trans);
+  }
+
+  // ------ Backward path ------
+  tlm::tlm_sync_enum nb_transport_bw(tlm::tlm_generic_payload &trans,
+                                     tlm::tlm_phase &phase,
+                                     sc_core::sc_time &delay) {
+    return target_socket->nb_transport_bw(trans, phase, delay);
+  }
+
+  void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end) {
+    target_socket->invalidate_direct_mem_ptr(start, end);
+  }
+
+  std::vector<EventClass> m_classes;
+  std::vector<int> m_eventIds;
+  std::vector<unsigned int> m_pending;
+  int m_lookup[2][nDensityBuckets][nBurstBuckets];
+  bool m_enabled = false;
+  bool m_flushPending = false;
+  sc_core::sc_event m_flushEvent{"flushEvent"};
+};
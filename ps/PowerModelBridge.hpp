@@ -8,6 +8,7 @@
 #pragma once
 
 #include "PowerModelChannelIf.hpp"
+#include "PowerModelConsumerIf.hpp"
 
 #include <spdlog/spdlog.h>
 // #include <systemc-ams>
@@ -16,11 +17,22 @@
 /**
  * @brief PowerModelBridge bridge between PowerModelChannel and sc_signals
  *
- * Updates i_out every time vcc is updated.
+ * Every timestep, writes the channel's current to i_out: its static current
+ * plus its event energy divided by v_in * timestep.
+ *
+ * Alternatively, a PowerModelConsumerIf can be set with setConsumer. The
+ * consumer is then called directly every timestep, and the voltage it returns
+ * is applied to the channel; i_out and v_in are ignored and may be left
+ * unbound. Without a consumer at the end of elaboration, both ports must be
+ * bound.
  */
 SC_MODULE(PowerModelBridge) {
-  sc_core::sc_out<double> i_out{"i_out"};
-  sc_core::sc_in<double> v_in{"v_in"};
+  sc_core::sc_port<sc_core::sc_signal_inout_if<double>, 1,
+                   sc_core::SC_ZERO_OR_MORE_BOUND>
+      i_out{"i_out"};
+  sc_core::sc_port<sc_core::sc_signal_in_if<double>, 1,
+                   sc_core::SC_ZERO_OR_MORE_BOUND>
+      v_in{"v_in"};
   PowerModelEventInPort powerModelPort{"PowerModelPort"};
 
   PowerModelBridge(const sc_core::sc_module_name name,
@@ -32,31 +44,57 @@ SC_MODULE(PowerModelBridge) {
     sensitive << v_in;
   }
 
-  void updateVcc() { powerModelPort->setSupplyVoltage(v_in.read()); }
+  /**
+   * @brief setConsumer couple a consumer directly to this bridge.
+   * @param consumer consumer to call every timestep, or nullptr to use the
+   * sc_signal ports.
+   */
+  void setConsumer(PowerModelConsumerIf *consumer) { m_consumer = consumer; }
+
+  virtual void end_of_elaboration() override {
+    // process() falls back to the signal ports without a consumer
+    if (m_consumer == nullptr && (i_out.size() == 0 || v_in.size() == 0)) {
+      SC_REPORT_FATAL(this->name(),
+                      "i_out and v_in must both be bound, unless a consumer "
+                      "is set with setConsumer during elaboration");
+    }
+  }
+
+  void updateVcc() {
+    if (v_in.size() > 0) {
+      powerModelPort->setSupplyVoltage(v_in->read());
+    }
+  }
 
   void process() {
-    i_out.write(0.0);
+    if (i_out.size() > 0) {
+      i_out->write(0.0);
+    }
     while (1) {
       wait(m_timestep);
       powerModelPort->getDynamicPower();
-      if (v_in.read() <= 0.0) {
+      if (m_consumer != nullptr) {
+        const double staticCurrent = powerModelPort->getStaticCurrent();
+        const double dynamicEnergy = powerModelPort->popDynamicEnergy();
+        powerModelPort->setSupplyVoltage(m_consumer->consume(
+            sc_core::sc_time_stamp(), staticCurrent, dynamicEnergy));
+      } else if (v_in->read() <= 0.0) {
         //Unused variables causes error for moonlight
         // volatile const double dynamicCurrent =
         //     powerModelPort->popDynamicEnergy() /
         //     (v_in.read() * m_timestep.to_seconds());
         // volatile const double i =
         //     powerModelPort->getStaticCurrent() + dynamicCurrent;
-        i_out.write(0.0);
+        i_out->write(0.0);
       } else {
         // Dynamic current = E/(v*ts)
         const double dynamicCurrent = powerModelPort->popDynamicEnergy() /
-                                      (v_in.read() * m_timestep.to_seconds());
-        // To avoid getStaticPower being called twice
-        const double staticCurrent = powerModelPort->getStaticCurrent() /
-                                      (v_in.read() * m_timestep.to_seconds());
+                                      (v_in->read() * m_timestep.to_seconds());
+        // Already a current, as passed to the consumer
+        const double staticCurrent = powerModelPort->getStaticCurrent();
 
         const double i = staticCurrent + dynamicCurrent;
-        i_out.write(i);
+        i_out->write(i);
 
         spdlog::info("{:s}: {:010d} us static {:.6f} mA dynamic {:.6f} mA", this->name(),
                     static_cast<long long unsigned int>(1e6 * sc_core::sc_time_stamp().to_seconds()),
@@ -68,4 +106,7 @@ SC_MODULE(PowerModelBridge) {
 
   // sc_core::sc_time m_lastReadTime{sc_core::SC_ZERO_TIME};
   const sc_core::sc_time m_timestep;
+
+ private:
+  PowerModelConsumerIf *m_consumer = nullptr;
 };
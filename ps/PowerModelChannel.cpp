@@ -6,9 +6,17 @@
  */
 
 #include "ps/PowerModelChannel.hpp"
+#include "ps/BitToggles.hpp"
+#include "ps/HistoryEnergyEvent.hpp"
+#include "ps/LookupTableCurrentState.hpp"
+#include "ps/LookupTableEnergyEvent.hpp"
+#include "ps/OperatingPointCurrentState.hpp"
+#include "ps/OperatingPointEnergyEvent.hpp"
 #include "ps/PowerModelEventBase.hpp"
 #include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <numeric>
@@ -40,6 +48,10 @@ PowerModelChannel::PowerModelChannel(const sc_module_name name,
                                    ? "none"
                                    : logFilePath + "/" + std::string(name) +
                                          "_event_power_log.csv"),
+      m_energyReportFileName(logFilePath == "none"
+                                 ? "none"
+                                 : logFilePath + "/" + std::string(name) +
+                                       "_energy_report.csv"),
       m_logTimestep(logTimestep) {
   if (logFilePath != "none") {
     // Make directory if it doesn't exist
@@ -81,13 +93,34 @@ PowerModelChannel::PowerModelChannel(const sc_module_name name,
   }
   SC_HAS_PROCESS(PowerModelChannel);
   SC_THREAD(logLoop);
+  SC_METHOD(scheduledStateProcess);
+  sensitive << m_scheduledStateEvent;
+  dont_initialize();
+  SC_METHOD(telemetryProcess);
 }
 
 PowerModelChannel::~PowerModelChannel() {
+  if (!m_eventLog.empty()) {
+    drainPendingEvents(true);
+  }
+  if (m_quantizationStep > 0.0) {
+    spdlog::info("{:s}: max. supply voltage quantization error {:g} V (bound "
+                 "{:g} V)",
+                 name(), m_maxQuantizationError, getQuantizationErrorBound());
+  }
+  if (m_clampedOffsetReports > 0) {
+    spdlog::warn("{:s}: {:d} event reports clamped to the decoupling horizon",
+                 name(), m_clampedOffsetReports);
+  }
+  if (m_ignoredOffsetReports > 0) {
+    spdlog::warn("{:s}: {:d} event reports with ignored local time offsets",
+                 name(), m_ignoredOffsetReports);
+  }
   dumpEventCsv();
   dumpStateCsv();
   dumpStaticPowerCsv();
   dumpEventPowerCsv();
+  dumpEnergyReport();
 }
 
 int PowerModelChannel::registerEvent(
@@ -106,9 +139,7 @@ int PowerModelChannel::registerEvent(
   unsigned int moduleId = -1;
   if (it == m_moduleNames.end()) {
     // This is the first registration for this module
-    moduleId = m_moduleNames.size();
-    m_moduleNames.push_back(moduleName);
-    m_stateLog.back().push_back(-1);
+    moduleId = addModule(moduleName);
   } else {
     // This is *not* the first event registration for this module
     // Check if event name already registered for the specified module name
@@ -125,10 +156,29 @@ int PowerModelChannel::registerEvent(
     }
   }
 
+  if (const auto t =
+          std::dynamic_pointer_cast<LookupTableEnergyEvent>(eventPtr)) {
+    addLookupTableBank(t->bank);
+  }
+  if (const auto t =
+          std::dynamic_pointer_cast<OperatingPointEnergyEvent>(eventPtr)) {
+    addOperatingPointTable(t->points, moduleId);
+  }
+
+  if (const auto h = std::dynamic_pointer_cast<HistoryEnergyEvent>(eventPtr)) {
+    // Tables stay valid, the channel shares ownership of the event
+    m_historyIndex.push_back(m_historyTables.size());
+    m_historyTables.push_back(
+        {h->nSymbols, h->next.data(), h->energy.data(), 0, 0.0, 0});
+  } else {
+    m_historyIndex.push_back(-1);
+  }
+
   // Add event to m_events
   const unsigned int id = m_events.size();
   m_events.emplace_back(std::move(eventPtr), moduleId);
   m_eventRates.push_back(0);
+  m_eventEnergyTotals.push_back(0.0);
   sc_assert(m_events.size() == m_eventRates.size());
   return id;
 }
@@ -149,9 +199,7 @@ int PowerModelChannel::registerState(
   unsigned int moduleId = -1;
   if (it == m_moduleNames.end()) {
     // This is the first state registration for this module
-    moduleId = m_moduleNames.size();
-    m_moduleNames.push_back(moduleName);
-    m_stateLog.back().push_back(-1);
+    moduleId = addModule(moduleName);
   } else {
     // This is *not* the first state registration for this module
     // Check if state name already registered for the specified module name
@@ -168,9 +216,19 @@ int PowerModelChannel::registerState(
     }
   }
 
+  if (const auto t =
+          std::dynamic_pointer_cast<LookupTableCurrentState>(statePtr)) {
+    addLookupTableBank(t->bank);
+  }
+  if (const auto t =
+          std::dynamic_pointer_cast<OperatingPointCurrentState>(statePtr)) {
+    addOperatingPointTable(t->points, moduleId);
+  }
+
   // Add state to m_states
   const unsigned int id = m_states.size();
   m_states.emplace_back(std::move(statePtr), moduleId);
+  m_stateLocalIndex.push_back(m_moduleStateCount[moduleId]++);
 
   // Set default state to first state registered for this module
   if (m_stateLog.back()[moduleId] == -1) {
@@ -181,6 +239,15 @@ int PowerModelChannel::registerState(
 }
 
 void PowerModelChannel::reportEvent(const unsigned int eventId, const unsigned int n) {
+  countEvent(eventId, n);
+  if (m_historyIndex[eventId] >= 0) {
+    // Stepped now, so plain and symbol reports keep their order
+    stepHistoryEvent(eventId, 0, n);
+  }
+}
+
+void PowerModelChannel::countEvent(const unsigned int eventId,
+                                   const unsigned int n) {
   if (!sc_is_running()) {
     throw std::runtime_error(
         "PowerModelEvent::reportEvent events can not be reported before"
@@ -190,6 +257,177 @@ void PowerModelChannel::reportEvent(const unsigned int eventId, const unsigned i
   sc_assert(eventId >= 0 && eventId < m_eventLog.back().size());
   m_eventRates[eventId] += n;
   m_eventLog.back()[eventId] += n;
+  m_contextCounts[eventId] += n;
+}
+
+void PowerModelChannel::reportEvent(const unsigned int eventId,
+                                    const unsigned int n,
+                                    const sc_time &localOffset) {
+  const uint64_t res = m_decouplingResolution.value();
+  // The ring is allocated at start of simulation, reportEvent rejects
+  // earlier reports
+  if (res == 0 || localOffset == SC_ZERO_TIME || m_pendingEvents.empty()) {
+    if (res == 0 && localOffset != SC_ZERO_TIME && !m_decouplingConfigured &&
+        m_ignoredOffsetReports++ == 0) {
+      spdlog::warn("{:s}: local time offsets are ignored without a log "
+                   "timestep, call setTemporalDecoupling",
+                   name());
+    }
+    reportEvent(eventId, n);
+    return;
+  }
+  sc_assert(eventId < m_events.size());
+
+  const uint64_t now = sc_time_stamp().value();
+  const uint64_t current = now / res;
+  uint64_t interval = (now + localOffset.value()) / res;
+  if (interval <= current) {
+    // Within the interval that is already underway
+    reportEvent(eventId, n);
+    return;
+  }
+  if (interval >= current + m_decouplingHorizon) {
+    if (m_clampedOffsetReports++ == 0) {
+      spdlog::warn("{:s}: local time offset {:s} beyond decoupling horizon, "
+                   "clamped; further clamps are only counted",
+                   name(), localOffset.to_string());
+    }
+    interval = current + m_decouplingHorizon - 1;
+  }
+  drainPendingEvents();
+  m_pendingEvents[(interval % m_decouplingHorizon) * m_events.size() +
+                  eventId] += n;
+  m_pendingTotal += n;
+  // Attributed to the context that reports it, not the one current at drain.
+  // History events are charged when stepped at drain.
+  m_contextCounts[eventId] += n;
+}
+
+void PowerModelChannel::reportHistoryEvent(const unsigned int eventId,
+                                           const unsigned int symbol,
+                                           const unsigned int n) {
+  sc_assert(eventId < m_events.size() && m_historyIndex[eventId] >= 0);
+  sc_assert(symbol < m_historyTables[m_historyIndex[eventId]].nSymbols);
+  countEvent(eventId, n);
+  stepHistoryEvent(eventId, symbol, n);
+}
+
+void PowerModelChannel::stepHistoryEvent(const unsigned int eventId,
+                                         const unsigned int symbol,
+                                         const unsigned int n) {
+  auto &h = m_historyTables[m_historyIndex[eventId]];
+  const double before = h.pendingEnergy;
+  for (unsigned int i = 0; i < n; ++i) {
+    const unsigned int idx = h.state * h.nSymbols + symbol;
+    h.pendingEnergy += h.energy[idx];
+    h.state = h.next[idx];
+  }
+  h.pendingCount += n;
+  // Charged here, foldContextCounts skips history events
+  auto &c = m_contexts[m_context];
+  c.dynamicEnergy += h.pendingEnergy - before;
+  c.eventEnergy[eventId] += h.pendingEnergy - before;
+}
+
+void PowerModelChannel::reportDataEvent(const unsigned int eventId,
+                                        const uint64_t prevData,
+                                        const uint64_t newData,
+                                        const unsigned int width) {
+  sc_assert(width <= 64);
+  reportEvent(eventId, countToggles(&prevData, &newData, width));
+}
+
+void PowerModelChannel::reportDataEvent(const unsigned int eventId,
+                                        const uint64_t *prevData,
+                                        const uint64_t *newData,
+                                        const unsigned int width) {
+  reportEvent(eventId, countToggles(prevData, newData, width));
+}
+
+void PowerModelChannel::reportDataBurst(const unsigned int eventId,
+                                        const uint64_t *prevData,
+                                        const uint64_t *beats,
+                                        const unsigned int nBeats,
+                                        const unsigned int width) {
+  reportEvent(eventId, countBurstToggles(prevData, beats, nBeats, width));
+}
+
+double PowerModelChannel::popHistoryEnergy(const unsigned int eventId,
+                                           const unsigned int n) {
+  auto &h = m_historyTables[m_historyIndex[eventId]];
+  // Every counted occurrence has been stepped
+  sc_assert(h.pendingCount == n);
+  const double energy = h.pendingEnergy;
+  h.pendingEnergy = 0.0;
+  h.pendingCount = 0;
+  return energy;
+}
+
+void PowerModelChannel::reportEvents(
+    const std::vector<PowerModelEventCount> &counts) {
+  if (!sc_is_running()) {
+    throw std::runtime_error(
+        "PowerModelEvent::reportEvents events can not be reported before "
+        "simulation has started. Events shall only be reported during "
+        "simulation");
+  }
+  auto &log = m_eventLog.back();
+  for (const auto &c : counts) {
+    sc_assert(c.eventId < m_events.size());
+    m_eventRates[c.eventId] += c.n;
+    log[c.eventId] += c.n;
+    m_contextCounts[c.eventId] += c.n;
+    if (m_historyIndex[c.eventId] >= 0) {
+      stepHistoryEvent(c.eventId, 0, c.n);
+    }
+  }
+}
+
+double PowerModelChannel::getEventEnergy(const unsigned int eventId) const {
+  sc_assert(eventId < m_events.size());
+  return eventEnergy(eventId);
+}
+
+void PowerModelChannel::drainPendingEvents(const bool all) {
+  const uint64_t res = m_decouplingResolution.value();
+  if (res == 0) {
+    return;
+  }
+  // Intervals before the present one have ended
+  const uint64_t end = sc_time_stamp().value() / res;
+  if (m_pendingTotal == 0) {
+    m_pendingBase = std::max(m_pendingBase, end);
+    return;
+  }
+  const unsigned int n = m_events.size();
+  for (; (m_pendingBase < end || all) && m_pendingTotal > 0; ++m_pendingBase) {
+    auto slot = &m_pendingEvents[(m_pendingBase % m_decouplingHorizon) * n];
+    for (unsigned int i = 0; i < n; ++i) {
+      if (slot[i] != 0) {
+        m_eventRates[i] += slot[i];
+        m_eventLog.back()[i] += slot[i];
+        if (m_historyIndex[i] >= 0) {
+          // Stepped when its interval is reached, in simulated-time order
+          stepHistoryEvent(i, 0, slot[i]);
+        }
+        m_pendingTotal -= slot[i];
+        slot[i] = 0;
+      }
+    }
+  }
+  m_pendingBase = std::max(m_pendingBase, end);
+}
+
+void PowerModelChannel::setTemporalDecoupling(const sc_time &resolution,
+                                              const unsigned int horizon) {
+  if (sc_is_running() || horizon == 0) {
+    throw std::invalid_argument(
+        "PowerModelChannel::setTemporalDecoupling must be called during "
+        "elaboration, with a non-zero horizon");
+  }
+  m_decouplingResolution = resolution;
+  m_decouplingHorizon = horizon;
+  m_decouplingConfigured = true;
 }
 
 void PowerModelChannel::reportState(const unsigned int stateId) {
@@ -200,61 +438,206 @@ void PowerModelChannel::reportState(const unsigned int stateId) {
         "simulation");
   }
   sc_assert(stateId >= 0 && stateId < m_states.size());
-  // FUTURE: Calculate and record fraction of timestep spent in the previous
-  // state
   const auto mid = m_states[stateId].moduleId;
-  m_stateLog.back()[mid] = stateId;
+  const auto previous = m_stateLog.back()[mid];
+  if (previous != static_cast<int>(stateId)) {
+    m_stateLog.back()[mid] = stateId;
+    const auto offset = m_transitionOffset[mid];
+    if (offset >= 0 && previous >= 0) {
+      const double energy =
+          m_transitionEnergy[offset +
+                             m_stateLocalIndex[previous] *
+                                 m_moduleStateCount[mid] +
+                             m_stateLocalIndex[stateId]];
+      m_pendingTransitionEnergy += energy;
+      m_moduleDynamicEnergy[mid] += energy;
+      m_totalDynamicEnergy += energy;
+      m_contexts[m_context].dynamicEnergy += energy;
+    }
+    // Charge the time spent in the previous state before switching
+    updateModuleCurrent(mid);
+    checkWatchers();
+  }
+}
+
+void PowerModelChannel::registerStateTransition(const unsigned int fromStateId,
+                                                const unsigned int toStateId,
+                                                const double energy,
+                                                const sc_time &latency) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "PowerModelChannel::registerStateTransition transitions can not be "
+        "registered after simulation has started.");
+  }
+  if (fromStateId >= m_states.size() || toStateId >= m_states.size() ||
+      fromStateId == toStateId ||
+      m_states[fromStateId].moduleId != m_states[toStateId].moduleId) {
+    throw std::invalid_argument(fmt::format(
+        FMT_STRING("PowerModelChannel::registerStateTransition invalid "
+                   "transition {:d} -> {:d}, states must be distinct states "
+                   "of the same module"),
+        fromStateId, toStateId));
+  }
+  m_stateTransitions.push_back({fromStateId, toStateId, energy, latency});
+}
+
+sc_time
+PowerModelChannel::getStateTransitionLatency(const unsigned int fromStateId,
+                                             const unsigned int toStateId) const {
+  sc_assert(fromStateId < m_states.size() && toStateId < m_states.size());
+  const auto mid = m_states[fromStateId].moduleId;
+  const auto offset = m_transitionOffset[mid];
+  if (offset < 0 || m_states[toStateId].moduleId != mid) {
+    return SC_ZERO_TIME;
+  }
+  return m_transitionLatency[offset +
+                             m_stateLocalIndex[fromStateId] *
+                                 m_moduleStateCount[mid] +
+                             m_stateLocalIndex[toStateId]];
+}
+
+void PowerModelChannel::buildTransitionMatrices() {
+  m_transitionEnergy.clear();
+  m_transitionLatency.clear();
+  std::fill(m_transitionOffset.begin(), m_transitionOffset.end(), -1);
+  for (const auto &t : m_stateTransitions) {
+    const auto mid = m_states[t.from].moduleId;
+    const auto n = m_moduleStateCount[mid];
+    if (m_transitionOffset[mid] < 0) {
+      m_transitionOffset[mid] = m_transitionEnergy.size();
+      m_transitionEnergy.resize(m_transitionEnergy.size() + n * n, 0.0);
+      m_transitionLatency.resize(m_transitionLatency.size() + n * n,
+                                 SC_ZERO_TIME);
+    }
+    const auto i = m_transitionOffset[mid] + m_stateLocalIndex[t.from] * n +
+                   m_stateLocalIndex[t.to];
+    m_transitionEnergy[i] = t.energy;
+    m_transitionLatency[i] = t.latency;
+  }
+}
+
+void PowerModelChannel::scheduleState(const unsigned int stateId,
+                                      const sc_time &delay) {
+  sc_assert(stateId < m_states.size());
+  const auto mid = m_states[stateId].moduleId;
+  const auto time = sc_time_stamp() + delay;
+  m_scheduledStates.push_back(
+      {time, m_scheduleSequence++, stateId, m_scheduleGenerations[mid]});
+  std::push_heap(m_scheduledStates.begin(), m_scheduledStates.end(),
+                 std::greater<ScheduledState>());
+  // sc_event keeps the earliest of its pending notifications
+  m_scheduledStateEvent.notify(m_scheduledStates.front().time -
+                               sc_time_stamp());
+}
+
+void PowerModelChannel::cancelScheduledStates(const unsigned int stateId) {
+  sc_assert(stateId < m_states.size());
+  ++m_scheduleGenerations[m_states[stateId].moduleId];
+}
+
+void PowerModelChannel::scheduledStateProcess() {
+  const auto now = sc_time_stamp();
+  while (!m_scheduledStates.empty() &&
+         m_scheduledStates.front().time <= now) {
+    const auto s = m_scheduledStates.front();
+    std::pop_heap(m_scheduledStates.begin(), m_scheduledStates.end(),
+                  std::greater<ScheduledState>());
+    m_scheduledStates.pop_back();
+    if (s.generation == m_scheduleGenerations[m_states[s.stateId].moduleId]) {
+      reportState(s.stateId);
+    }
+  }
+  if (!m_scheduledStates.empty()) {
+    m_scheduledStateEvent.notify(m_scheduledStates.front().time - now);
+  }
 }
 
 int PowerModelChannel::popEventCount(const unsigned int eventId) {
+  const auto n = takeEventCount(eventId);
+  if (m_historyIndex[eventId] >= 0) {
+    // Popped as a count, the energy is not accounted for
+    popHistoryEnergy(eventId, n);
+  }
+  return n;
+}
+
+unsigned int PowerModelChannel::takeEventCount(const unsigned int eventId) {
   sc_assert(eventId >= 0 && eventId < m_eventLog.back().size());
+  if (m_pendingTotal != 0) {
+    drainPendingEvents();
+  }
   const auto tmp = m_eventRates[eventId];
   m_eventRates[eventId] = 0;
   return tmp;
 }
 
 double PowerModelChannel::popEventEnergy(const unsigned int eventId) {
-  sc_assert(eventId >= 0 && eventId < m_eventLog.back().size());
-  return m_events[eventId].event->calculateEnergy(m_supplyVoltage) *
-         popEventCount(eventId);
+  const double energy = accumulateEventEnergy(eventId);
+  if (energy != 0.0) {
+    checkWatchers();
+  }
+  return energy;
+}
+
+double PowerModelChannel::accumulateEventEnergy(const unsigned int eventId) {
+  const auto n = takeEventCount(eventId);
+  if (n == 0) {
+    return 0.0;
+  }
+  const double energy = m_historyIndex[eventId] < 0
+                            ? eventEnergy(eventId) * n
+                            : popHistoryEnergy(eventId, n);
+  m_eventEnergyTotals[eventId] += energy;
+  m_moduleDynamicEnergy[m_events[eventId].moduleId] += energy;
+  m_totalDynamicEnergy += energy;
+  return energy;
 }
 
 double PowerModelChannel::popDynamicEnergy() {
-  double result = 0.0;
+  double result = m_pendingTransitionEnergy;
+  m_pendingTransitionEnergy = 0.0;
   for (unsigned int i = 0; i < m_events.size(); ++i) {
-    result += popEventEnergy(i);
+    result += accumulateEventEnergy(i);
   }
+
+  // Average event power since the last pop, for power watchers
+  const auto now = sc_time_stamp();
+  if (now > m_lastPopTime) {
+    m_dynamicPower = result / (now - m_lastPopTime).to_seconds();
+    m_lastPopTime = now;
+  }
+  checkWatchers();
   return result;
 }
 
 double PowerModelChannel::getStaticCurrent() {
-  // TEST
   // Log current for each module
   m_staticPowerLog.emplace_back(m_stateLog.back().size() + 1, 0.0);
   m_staticPowerLog.back().back() = sc_time_stamp().to_seconds();
-  for (unsigned int i = 0; i < m_stateLog.back().size() - 1; ++i) {
-    const auto &stateId = m_stateLog.back()[i];
-    m_staticPowerLog.back()[i] =
-        stateId >= 0
-            ? m_supplyVoltage *
-                  m_states[stateId].state->calculateCurrent(m_supplyVoltage)
-            : 0.0;
+  double result = 0.0;
+  for (unsigned int i = 0; i < m_moduleNames.size(); ++i) {
+    updateModuleCurrent(i);
+    m_staticPowerLog.back()[i] = moduleVoltage(i) * m_moduleCurrents[i];
+    result += m_moduleCurrents[i];
   }
 
+  // Re-sync the running totals, which are updated incrementally elsewhere
+  std::fill(m_domainCurrents.begin(), m_domainCurrents.end(), 0.0);
+  for (unsigned int i = 0; i < m_moduleNames.size(); ++i) {
+    m_domainCurrents[m_moduleDomain[i]] += m_moduleCurrents[i];
+  }
+  if (m_domainVoltages.size() > 1 && m_supplyVoltage > 0.0) {
+    // Refer the other domains' power to the channel's own supply
+    result = staticPower() / m_supplyVoltage;
+  }
+  checkWatchers();
+
   if (m_staticPowerLog.size() > m_logDumpThreshold) {
     dumpStaticPowerCsv();
     m_staticPowerLog.clear();
   }
 
-  // TEST
-  return std::accumulate(
-      m_stateLog.back().begin(), m_stateLog.back().end() - 1, 0.0,
-      [=](const double &sum, const unsigned int &stateId) {
-        // Ignore invalid (uninitialized) states
-        return stateId >= 0 ? sum + m_states[stateId].state->calculateCurrent(
-                                        m_supplyVoltage)
-                            : sum;
-      });
+  return result;
 }
 
 //___________ADDITION_________________________________
@@ -271,7 +654,7 @@ void PowerModelChannel::getDynamicPower() {
       // Second to last eventLog entry
       int numberOfEvents = m_eventLog[m_eventLog.size()-1][i];
       // P = (n_event*E_event)/t_log
-      const double dynamicPower = numberOfEvents * m_events[i].event->calculateEnergy(m_supplyVoltage) / m_logTimestep.to_seconds();
+      const double dynamicPower = numberOfEvents * eventEnergy(i) / m_logTimestep.to_seconds();
       m_eventPowerLog.back()[eventId] = dynamicPower;
     }
 
@@ -298,6 +681,243 @@ void PowerModelChannel::getDynamicPower() {
 //_________________________________________________________________________
 
 
+unsigned int PowerModelChannel::addModule(const std::string &moduleName) {
+  const unsigned int moduleId = m_moduleNames.size();
+  m_moduleNames.push_back(moduleName);
+  m_stateLog.back().push_back(-1);
+  m_moduleDynamicEnergy.push_back(0.0);
+  m_moduleStaticEnergy.push_back(0.0);
+  m_moduleCurrents.push_back(0.0);
+  m_moduleStaticTime.push_back(SC_ZERO_TIME);
+  m_scheduleGenerations.push_back(0);
+  m_moduleStateCount.push_back(0);
+  m_transitionOffset.push_back(-1);
+  m_moduleDomain.push_back(0);
+  buildDomainRanges();
+  return moduleId;
+}
+
+void PowerModelChannel::integrateStaticEnergy(const unsigned int moduleId) {
+  const auto now = sc_time_stamp();
+  const double energy =
+      moduleVoltage(moduleId) * m_moduleCurrents[moduleId] *
+      (now - m_moduleStaticTime[moduleId]).to_seconds();
+  m_moduleStaticEnergy[moduleId] += energy;
+  m_moduleStaticTime[moduleId] = now;
+}
+
+void PowerModelChannel::integrateTotalStaticEnergy() {
+  const auto now = sc_time_stamp();
+  m_totalStaticEnergy += staticPower() * (now - m_staticTime).to_seconds();
+  m_staticTime = now;
+}
+
+void PowerModelChannel::updateModuleCurrent(const unsigned int moduleId) {
+  integrateStaticEnergy(moduleId);
+  integrateTotalStaticEnergy();
+  const auto stateId = m_stateLog.back()[moduleId];
+  const double current = stateId >= 0 ? stateCurrent(stateId) : 0.0;
+  m_domainCurrents[m_moduleDomain[moduleId]] +=
+      current - m_moduleCurrents[moduleId];
+  m_moduleCurrents[moduleId] = current;
+}
+
+int PowerModelChannel::getModuleId(const std::string moduleName) const {
+  const auto it =
+      std::find(m_moduleNames.begin(), m_moduleNames.end(), moduleName);
+  return it == m_moduleNames.end() ? -1 : it - m_moduleNames.begin();
+}
+
+double PowerModelChannel::getModuleEnergy(const unsigned int moduleId) {
+  sc_assert(moduleId < m_moduleNames.size());
+  integrateStaticEnergy(moduleId);
+  return m_moduleDynamicEnergy[moduleId] + m_moduleStaticEnergy[moduleId];
+}
+
+void PowerModelChannel::refreshStateCurrents(const unsigned int moduleId) {
+  sc_assert(moduleId < m_moduleNames.size());
+  for (auto &s : m_states) {
+    if (s.moduleId == moduleId) {
+      s.uncached = true;
+    }
+  }
+  updateModuleCurrent(moduleId);
+  checkWatchers();
+}
+
+double
+PowerModelChannel::getEventEnergyTotal(const unsigned int eventId) const {
+  sc_assert(eventId < m_events.size());
+  return m_eventEnergyTotals[eventId];
+}
+
+double PowerModelChannel::getTotalEnergy() {
+  integrateTotalStaticEnergy();
+  return m_totalDynamicEnergy + m_totalStaticEnergy;
+}
+
+unsigned int PowerModelChannel::registerContext(const std::string contextName) {
+  const auto it = std::find_if(
+      m_contexts.begin(), m_contexts.end(),
+      [&contextName](const Context &c) { return c.name == contextName; });
+  if (it != m_contexts.end()) {
+    return it - m_contexts.begin();
+  }
+  m_contexts.emplace_back(contextName);
+  if (m_contextCounts != nullptr) {
+    // The current context's entry may have moved
+    m_contextCounts = m_contexts[m_context].counts.data();
+  }
+  return m_contexts.size() - 1;
+}
+
+void PowerModelChannel::setContext(const unsigned int contextId) {
+  sc_assert(contextId < m_contexts.size());
+  if (contextId == m_context) {
+    return;
+  }
+  chargeContextStaticEnergy();
+  m_context = contextId;
+  if (m_contextCounts != nullptr) {
+    activateContext();
+  }
+}
+
+double PowerModelChannel::getContextEnergy(const unsigned int contextId) {
+  sc_assert(contextId < m_contexts.size());
+  chargeContextStaticEnergy();
+  foldContextCounts();
+  const auto &c = m_contexts[contextId];
+  return c.dynamicEnergy + c.staticEnergy;
+}
+
+double PowerModelChannel::getContextEventEnergy(const unsigned int contextId,
+                                                const unsigned int eventId) {
+  sc_assert(contextId < m_contexts.size() && eventId < m_events.size());
+  foldContextCounts();
+  const auto &c = m_contexts[contextId];
+  // Never activated contexts have no energy
+  return eventId < c.eventEnergy.size() ? c.eventEnergy[eventId] : 0.0;
+}
+
+void PowerModelChannel::activateContext() {
+  auto &c = m_contexts[m_context];
+  if (c.counts.size() < m_events.size()) {
+    c.counts.resize(m_events.size(), 0);
+    c.eventEnergy.resize(m_events.size(), 0.0);
+  }
+  m_contextCounts = c.counts.data();
+}
+
+void PowerModelChannel::chargeContextStaticEnergy() {
+  integrateTotalStaticEnergy();
+  m_contexts[m_context].staticEnergy +=
+      m_totalStaticEnergy - m_contextStaticMark;
+  m_contextStaticMark = m_totalStaticEnergy;
+}
+
+void PowerModelChannel::foldContextCounts() {
+  for (auto &c : m_contexts) {
+    for (unsigned int i = 0; i < c.counts.size(); ++i) {
+      if (c.counts[i] != 0) {
+        // History events are charged as they are stepped
+        if (m_historyIndex[i] < 0) {
+          const double energy = c.counts[i] * eventEnergy(i);
+          c.dynamicEnergy += energy;
+          c.eventEnergy[i] += energy;
+        }
+        c.counts[i] = 0;
+      }
+    }
+  }
+}
+
+int PowerModelChannel::registerPowerWatcher(const double threshold) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "PowerModelChannel::registerPowerWatcher watchers can not be "
+        "registered after simulation has started.");
+  }
+  m_watchers.emplace_back(threshold, false);
+  return m_watchers.size() - 1;
+}
+
+int PowerModelChannel::registerEnergyWatcher(const double threshold) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "PowerModelChannel::registerEnergyWatcher watchers can not be "
+        "registered after simulation has started.");
+  }
+  m_watchers.emplace_back(threshold, true);
+  return m_watchers.size() - 1;
+}
+
+void PowerModelChannel::rearmWatcher(const unsigned int watcherId) {
+  sc_assert(watcherId < m_watchers.size());
+  auto &w = m_watchers[watcherId];
+  if (w.isEnergyWatcher) {
+    w.checkpoint = getTotalEnergy();
+    w.event->cancel();
+    w.scheduled = false;
+  }
+  w.armed = true;
+  checkWatchers();
+}
+
+const sc_event &
+PowerModelChannel::watcherEvent(const unsigned int watcherId) const {
+  sc_assert(watcherId < m_watchers.size());
+  return *m_watchers[watcherId].event;
+}
+
+void PowerModelChannel::checkWatchers() {
+  if (m_watchers.empty()) {
+    return;
+  }
+
+  const auto now = sc_time_stamp();
+  const double staticPower = this->staticPower();
+  const double energy = getTotalEnergy();
+  for (auto &w : m_watchers) {
+    if (!w.isEnergyWatcher) {
+      // Edge-triggered: fire on the upward crossing, re-arm when below
+      if (staticPower + m_dynamicPower > w.threshold) {
+        if (w.armed) {
+          w.event->notify(SC_ZERO_TIME);
+          w.armed = false;
+        }
+      } else {
+        w.armed = true;
+      }
+      continue;
+    }
+
+    if (!w.armed) {
+      continue;
+    }
+    if (w.scheduled && w.crossingTime <= now) {
+      // The predicted crossing has already been notified
+      w.armed = false;
+      w.scheduled = false;
+      continue;
+    }
+
+    const double remaining = w.threshold - (energy - w.checkpoint);
+    w.event->cancel();
+    w.scheduled = false;
+    if (remaining <= 0.0) {
+      w.event->notify(SC_ZERO_TIME);
+      w.armed = false;
+    } else if (staticPower > 0.0) {
+      // Predict when state energy alone will cross the threshold
+      const auto delay = sc_time::from_seconds(remaining / staticPower);
+      w.event->notify(delay);
+      w.crossingTime = now + delay;
+      w.scheduled = true;
+    }
+  }
+}
+
 void PowerModelChannel::start_of_simulation() {
   // Initialize event and state log
   m_eventLog.emplace_back(m_events.size() + 1, 0);
@@ -309,6 +929,37 @@ void PowerModelChannel::start_of_simulation() {
   m_stateLog.back().push_back(
       static_cast<int>(m_logTimestep.to_seconds() * 1.0e6));
 
+  buildTransitionMatrices();
+  buildOperatingPointDomains();
+  checkLookupTableDomains();
+  activateContext();
+
+  // Ring of pending intervals for decoupled events, defaults to log timestep
+  if (!m_decouplingConfigured) {
+    m_decouplingResolution = m_logTimestep;
+  }
+  m_pendingEvents.assign(m_decouplingHorizon * m_events.size(), 0);
+
+  // Tables cached during elaboration may predate some registrations
+  if (m_voltageTables != nullptr) {
+    const long bucket = m_voltageTables->bucket;
+    m_voltageTableCache.clear();
+    m_voltageTables = nullptr;
+    selectVoltageTables(bucket);
+  }
+  if (m_quantizationStep > 0.0) {
+    spdlog::info("{:s}: supply voltage quantized to {:g} V steps, error bound "
+                 "{:g} V",
+                 name(), m_quantizationStep, getQuantizationErrorBound());
+  }
+
+  // Initial module currents, based on the default states
+  updateLookupTables();
+  for (unsigned int i = 0; i < m_moduleNames.size(); ++i) {
+    updateModuleCurrent(i);
+  }
+  checkWatchers();
+
   // Print list of events & states
   spdlog::info("-- PowerModelChannel Registered Events & States ------");
   for (unsigned int i = 0; i < m_moduleNames.size(); ++i) {
@@ -327,6 +978,54 @@ void PowerModelChannel::start_of_simulation() {
   spdlog::info("----------------------------------------------");
 }
 
+void PowerModelChannel::enableTelemetry(const std::string &segmentName,
+                                        const sc_time &period) {
+  if (segmentName.empty() || segmentName.find('/') != std::string::npos) {
+    throw std::invalid_argument(fmt::format(
+        "PowerModelChannel::enableTelemetry invalid segment name '{:s}'",
+        segmentName));
+  }
+  const sc_time p = period == SC_ZERO_TIME ? m_logTimestep : period;
+  if (p == SC_ZERO_TIME) {
+    throw std::invalid_argument("PowerModelChannel::enableTelemetry needs a "
+                                "period when the log timestep is zero");
+  }
+  m_telemetryName = segmentName;
+  m_telemetryPeriod = p;
+}
+
+void PowerModelChannel::telemetryProcess() {
+  if (m_telemetry == nullptr) {
+    // Initialization run
+    if (m_telemetryName.empty()) {
+      return;
+    }
+    m_telemetry.reset(new TelemetryWriter(m_telemetryName, m_moduleNames));
+    m_telemetryEnergy.assign(m_moduleNames.size(), 0.0);
+    m_telemetrySnapshot.modulePower.assign(m_moduleNames.size(), 0.0);
+    spdlog::info("{:s}: publishing telemetry to /{:s} every {:s}", name(),
+                 m_telemetryName, m_telemetryPeriod.to_string());
+  }
+
+  const auto now = sc_time_stamp();
+  const double dt = (now - m_telemetryTime).to_seconds();
+  auto &s = m_telemetrySnapshot;
+  for (unsigned int i = 0; i < m_moduleNames.size(); ++i) {
+    const double energy = m_moduleDynamicEnergy[i] - m_telemetryEnergy[i];
+    m_telemetryEnergy[i] = m_moduleDynamicEnergy[i];
+    s.modulePower[i] = moduleVoltage(i) * m_moduleCurrents[i] +
+                       (dt > 0.0 ? energy / dt : 0.0);
+  }
+  s.time = now.to_seconds();
+  s.supplyVoltage = m_supplyVoltage;
+  s.staticPower = staticPower();
+  s.dynamicPower = m_dynamicPower;
+  s.totalEnergy = getTotalEnergy();
+  m_telemetry->publish(s);
+  m_telemetryTime = now;
+  next_trigger(m_telemetryPeriod);
+}
+
 void PowerModelChannel::logLoop() {
   if (m_eventLogFileName == "none" || m_logTimestep == SC_ZERO_TIME) {
     SC_REPORT_INFO(this->name(), "Logging disabled.");
@@ -336,6 +1035,8 @@ void PowerModelChannel::logLoop() {
   while (1) {
     // Wait for a timestep
     wait(m_logTimestep);
+    // Account for decoupled events of the interval that just ended
+    drainPendingEvents();
     // Copy current state (excluding time stamp)
     const auto currentState = std::vector<int>(m_stateLog.back());
     // Dump file when log exceeds threshold
@@ -488,8 +1189,373 @@ void PowerModelChannel::dumpEventPowerCsv() {
 }
 
 void PowerModelChannel::setSupplyVoltage(const double val) {
-  if (m_supplyVoltage != val) {
-    m_supplyVoltage = val;
+  double v = val;
+  long bucket = 0;
+  if (m_quantizationStep > 0.0) {
+    // Stay in the present bucket unless val is outside it by more than the
+    // hysteresis
+    if (m_voltageTables != nullptr &&
+        std::fabs(val - m_supplyVoltage) <= getQuantizationErrorBound()) {
+      v = m_supplyVoltage;
+    } else {
+      bucket = std::lround(val / m_quantizationStep);
+      v = bucket * m_quantizationStep;
+    }
+    m_maxQuantizationError =
+        std::max(m_maxQuantizationError, std::fabs(val - v));
+  }
+
+  if (m_supplyVoltage != v ||
+      (m_quantizationStep > 0.0 && m_voltageTables == nullptr)) {
+    // Integrate state energy at the old voltage before switching
+    for (unsigned int i = m_domainStart[0]; i < m_domainStart[1]; ++i) {
+      integrateStaticEnergy(m_domainModules[i]);
+    }
+    integrateTotalStaticEnergy();
+    foldContextCounts();
+    m_supplyVoltage = v;
+    m_domainVoltages[0] = v;
+    if (m_quantizationStep > 0.0) {
+      selectVoltageTables(bucket);
+    }
+    updateLookupTables();
+    for (unsigned int i = m_domainStart[0]; i < m_domainStart[1]; ++i) {
+      updateModuleCurrent(m_domainModules[i]);
+    }
+    checkWatchers();
     m_supplyVoltageChangedEvent.notify(SC_ZERO_TIME);
   }
 }
+
+void PowerModelChannel::setSupplyVoltage(const unsigned int domainId,
+                                         const double val) {
+  sc_assert(domainId < m_domainVoltages.size());
+  if (domainId == 0) {
+    setSupplyVoltage(val);
+    return;
+  }
+  if (m_domainVoltages[domainId] == val) {
+    return;
+  }
+  // Integrate state energy at the old voltage before switching
+  const auto begin = m_domainStart[domainId];
+  const auto end = m_domainStart[domainId + 1];
+  for (unsigned int i = begin; i < end; ++i) {
+    integrateStaticEnergy(m_domainModules[i]);
+  }
+  integrateTotalStaticEnergy();
+  foldContextCounts();
+  m_domainVoltages[domainId] = val;
+  for (unsigned int i = begin; i < end; ++i) {
+    updateModuleCurrent(m_domainModules[i]);
+  }
+  checkWatchers();
+  m_supplyVoltageChangedEvent.notify(SC_ZERO_TIME);
+}
+
+double PowerModelChannel::getSupplyVoltage(const unsigned int domainId) const {
+  sc_assert(domainId < m_domainVoltages.size());
+  return m_domainVoltages[domainId];
+}
+
+unsigned int PowerModelChannel::addVoltageDomain(const std::string domainName) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "PowerModelChannel::addVoltageDomain domains can not be added after "
+        "simulation has started.");
+  }
+  if (std::find(m_domainNames.begin(), m_domainNames.end(), domainName) !=
+      m_domainNames.end()) {
+    throw std::invalid_argument(fmt::format(
+        FMT_STRING("PowerModelChannel::addVoltageDomain domain '{:s}' already "
+                   "added"),
+        domainName));
+  }
+  m_domainNames.push_back(domainName);
+  m_domainVoltages.push_back(0.0);
+  m_domainCurrents.push_back(0.0);
+  buildDomainRanges();
+  return m_domainNames.size() - 1;
+}
+
+void PowerModelChannel::setModuleDomain(const std::string moduleName,
+                                        const unsigned int domainId) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "PowerModelChannel::setModuleDomain modules can not be moved after "
+        "simulation has started.");
+  }
+  const int moduleId = getModuleId(moduleName);
+  if (moduleId < 0 || domainId >= m_domainNames.size()) {
+    throw std::invalid_argument(fmt::format(
+        FMT_STRING("PowerModelChannel::setModuleDomain unknown module '{:s}' "
+                   "or domain {:d}"),
+        moduleName, domainId));
+  }
+  const auto previous = m_moduleDomain[moduleId];
+  m_moduleDomain[moduleId] = domainId;
+  try {
+    checkLookupTableDomains();
+  } catch (const std::invalid_argument &) {
+    m_moduleDomain[moduleId] = previous;
+    throw;
+  }
+  buildDomainRanges();
+}
+
+void PowerModelChannel::buildDomainRanges() {
+  // Counting sort of the module ids by domain
+  const unsigned int nDomains = m_domainNames.size();
+  m_domainStart.assign(nDomains + 1, 0);
+  for (const auto d : m_moduleDomain) {
+    m_domainStart[d + 1]++;
+  }
+  for (unsigned int d = 0; d < nDomains; ++d) {
+    m_domainStart[d + 1] += m_domainStart[d];
+  }
+  m_domainModules.resize(m_moduleDomain.size());
+  auto next = m_domainStart;
+  for (unsigned int i = 0; i < m_moduleDomain.size(); ++i) {
+    m_domainModules[next[m_moduleDomain[i]]++] = i;
+  }
+}
+
+void PowerModelChannel::setOperatingPoint(const unsigned int point,
+                                          const unsigned int domainId) {
+  sc_assert(domainId < m_domainVoltages.size());
+  if (domainId == 0 && m_quantizationStep > 0.0) {
+    throw std::runtime_error(
+        "PowerModelChannel::setOperatingPoint operating points can not be "
+        "combined with voltage quantization");
+  }
+  if (!sc_is_running()) {
+    // Modules may still be moved between domains
+    buildOperatingPointDomains();
+  }
+  const auto &tables = m_domainOperatingPoints[domainId];
+  if (!tables.empty() && point >= tables.front()->points().size()) {
+    throw std::invalid_argument(fmt::format(
+        "PowerModelChannel::setOperatingPoint no operating point {:d} in "
+        "domain {:d}",
+        point, domainId));
+  }
+  // Integrate state energy at the old operating point before switching
+  const auto begin = m_domainStart[domainId];
+  const auto end = m_domainStart[domainId + 1];
+  for (unsigned int i = begin; i < end; ++i) {
+    integrateStaticEnergy(m_domainModules[i]);
+  }
+  integrateTotalStaticEnergy();
+  foldContextCounts();
+
+  double v = m_domainVoltages[domainId];
+  for (auto t : tables) {
+    t->select(point);
+  }
+  if (!tables.empty()) {
+    v = tables.front()->points()[point].voltage;
+  }
+  const bool voltageChanged = v != m_domainVoltages[domainId];
+  m_domainVoltages[domainId] = v;
+  if (domainId == 0) {
+    m_supplyVoltage = v;
+    updateLookupTables();
+  }
+  for (unsigned int i = begin; i < end; ++i) {
+    updateModuleCurrent(m_domainModules[i]);
+  }
+  checkWatchers();
+  if (voltageChanged) {
+    m_supplyVoltageChangedEvent.notify(SC_ZERO_TIME);
+  }
+}
+
+void PowerModelChannel::buildOperatingPointDomains() {
+  m_domainOperatingPoints.assign(m_domainVoltages.size(), {});
+  for (const auto &u : m_operatingPointTables) {
+    const auto domain = m_moduleDomain[u.moduleId];
+    for (const auto &other : m_operatingPointTables) {
+      if (other.table == u.table && m_moduleDomain[other.moduleId] != domain) {
+        throw std::invalid_argument(fmt::format(
+            "PowerModelChannel::setOperatingPoint modules {:s} and {:s} share "
+            "an operating point table across voltage domains",
+            m_moduleNames[u.moduleId], m_moduleNames[other.moduleId]));
+      }
+    }
+
+    auto &tables = m_domainOperatingPoints[domain];
+    if (std::find(tables.begin(), tables.end(), u.table.get()) !=
+        tables.end()) {
+      continue;
+    }
+    if (!tables.empty()) {
+      const auto &a = tables.front()->points();
+      const auto &b = u.table->points();
+      const bool same =
+          a.size() == b.size() &&
+          std::equal(a.begin(), a.end(), b.begin(),
+                     [](const OperatingPointTable::OperatingPoint &x,
+                        const OperatingPointTable::OperatingPoint &y) {
+                       return x.voltage == y.voltage &&
+                              x.frequency == y.frequency;
+                     });
+      if (!same) {
+        throw std::invalid_argument(fmt::format(
+            "PowerModelChannel::setOperatingPoint module {:s} uses different "
+            "operating points than the rest of domain {:s}",
+            m_moduleNames[u.moduleId], m_domainNames[domain]));
+      }
+    }
+    tables.push_back(u.table.get());
+  }
+}
+
+void PowerModelChannel::addOperatingPointTable(
+    const std::shared_ptr<OperatingPointTable> &table,
+    const unsigned int moduleId) {
+  if (std::none_of(m_operatingPointTables.begin(),
+                   m_operatingPointTables.end(),
+                   [&](const OperatingPointUse &u) {
+                     return u.table == table && u.moduleId == moduleId;
+                   })) {
+    m_operatingPointTables.push_back({table, moduleId});
+  }
+}
+
+void PowerModelChannel::addLookupTableBank(
+    const std::shared_ptr<LookupTableBank> &bank) {
+  if (std::find(m_lookupTableBanks.begin(), m_lookupTableBanks.end(), bank) ==
+      m_lookupTableBanks.end()) {
+    m_lookupTableBanks.push_back(bank);
+  }
+}
+
+void PowerModelChannel::setVoltageQuantization(const double step,
+                                               const double hysteresis,
+                                               const unsigned int cacheSize) {
+  if (step < 0.0 || hysteresis < 0.0 || (step > 0.0 && cacheSize == 0)) {
+    throw std::invalid_argument(fmt::format(
+        FMT_STRING("PowerModelChannel::setVoltageQuantization invalid "
+                   "step={:g}, hysteresis={:g}, cacheSize={:d}"),
+        step, hysteresis, cacheSize));
+  }
+  m_quantizationStep = step;
+  m_quantizationHysteresis = hysteresis;
+  m_voltageTableCacheSize = cacheSize;
+  m_voltageTableCache.clear();
+  m_voltageTables = nullptr;
+}
+
+void PowerModelChannel::selectVoltageTables(const long bucket) {
+  const auto it = std::find_if(
+      m_voltageTableCache.begin(), m_voltageTableCache.end(),
+      [bucket](const VoltageTables &t) { return t.bucket == bucket; });
+  if (it != m_voltageTableCache.end()) {
+    // Move to front, list nodes (and m_voltageTables) stay valid
+    m_voltageTableCache.splice(m_voltageTableCache.begin(), m_voltageTableCache,
+                               it);
+  } else {
+    if (m_voltageTableCache.size() >= m_voltageTableCacheSize) {
+      m_voltageTableCache.pop_back();
+    }
+    updateLookupTables();
+    VoltageTables t{bucket, {}, {}};
+    t.eventEnergy.reserve(m_events.size());
+    for (const auto &e : m_events) {
+      t.eventEnergy.push_back(e.event->calculateEnergy(m_supplyVoltage));
+    }
+    t.stateCurrent.reserve(m_states.size());
+    for (const auto &s : m_states) {
+      t.stateCurrent.push_back(s.state->calculateCurrent(m_supplyVoltage));
+    }
+    m_voltageTableCache.push_front(std::move(t));
+  }
+  m_voltageTables = &m_voltageTableCache.front();
+}
+
+void PowerModelChannel::checkLookupTableDomains() const {
+  const auto check = [this](const unsigned int moduleId, const bool lut) {
+    if (lut && m_moduleDomain[moduleId] != 0) {
+      throw std::invalid_argument(fmt::format(
+          "PowerModelChannel::checkLookupTableDomains module {:s} uses lookup "
+          "tables, which only support domain 0, but is in domain {:s}",
+          m_moduleNames[moduleId], m_domainNames[m_moduleDomain[moduleId]]));
+    }
+  };
+  for (const auto &e : m_events) {
+    check(e.moduleId,
+          std::dynamic_pointer_cast<LookupTableEnergyEvent>(e.event) !=
+              nullptr);
+  }
+  for (const auto &s : m_states) {
+    check(s.moduleId,
+          std::dynamic_pointer_cast<LookupTableCurrentState>(s.state) !=
+              nullptr);
+  }
+}
+
+void PowerModelChannel::updateLookupTables() {
+  for (const auto &bank : m_lookupTableBanks) {
+    bank->setVoltage(m_supplyVoltage);
+  }
+}
+
+void PowerModelChannel::dumpEnergyReport() {
+  if (m_energyReportFileName == "none") {
+    return;
+  }
+  // Bring state energy up to date
+  getTotalEnergy();
+
+  std::ofstream f(m_energyReportFileName, std::ios::out | std::ios::trunc);
+  spdlog::info("-- PowerModelChannel Energy Breakdown ----------------");
+
+  // Per-module totals
+  f << "module,dynamic(J),static(J),total(J)\n";
+  for (unsigned int i = 0; i < m_moduleNames.size(); ++i) {
+    const double total = m_moduleDynamicEnergy[i] + m_moduleStaticEnergy[i];
+    f << m_moduleNames[i] << ',' << m_moduleDynamicEnergy[i] << ','
+      << m_moduleStaticEnergy[i] << ',' << total << '\n';
+    spdlog::info("\t<module> {:s}: {:.6f} uJ", m_moduleNames[i], total * 1e6);
+  }
+  f << "total," << m_totalDynamicEnergy << ',' << m_totalStaticEnergy << ','
+    << m_totalDynamicEnergy + m_totalStaticEnergy << '\n';
+
+  f << "\n\n";
+
+  // Per-event totals
+  f << "module,event,energy(J)\n";
+  for (unsigned int i = 0; i < m_events.size(); ++i) {
+    f << m_moduleNames[m_events[i].moduleId] << ',' << m_events[i].event->name
+      << ',' << m_eventEnergyTotals[i] << '\n';
+  }
+  spdlog::info("\ttotal: {:.6f} uJ",
+               (m_totalDynamicEnergy + m_totalStaticEnergy) * 1e6);
+
+  // Per-context totals
+  chargeContextStaticEnergy();
+  foldContextCounts();
+  f << "\n\n";
+  f << "context,dynamic(J),static(J),total(J)\n";
+  for (const auto &c : m_contexts) {
+    const double total = c.dynamicEnergy + c.staticEnergy;
+    f << c.name << ',' << c.dynamicEnergy << ',' << c.staticEnergy << ','
+      << total << '\n';
+    if (m_contexts.size() > 1) {
+      spdlog::info("\t<context> {:s}: {:.6f} uJ", c.name, total * 1e6);
+    }
+  }
+
+  // Per-context event energy, events with energy in the context only
+  f << "\n\n";
+  f << "context,module,event,energy(J)\n";
+  for (const auto &c : m_contexts) {
+    for (unsigned int i = 0; i < c.eventEnergy.size(); ++i) {
+      if (c.eventEnergy[i] != 0.0) {
+        f << c.name << ',' << m_moduleNames[m_events[i].moduleId] << ','
+          << m_events[i].event->name << ',' << c.eventEnergy[i] << '\n';
+      }
+    }
+  }
+  spdlog::info("----------------------------------------------");
+}
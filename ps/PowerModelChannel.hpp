@@ -7,8 +7,12 @@
 
 #pragma once
 
+#include "LookupTableBank.hpp"
+#include "OperatingPointTable.hpp"
 #include "PowerModelChannelIf.hpp"
 #include "PowerModelEventBase.hpp"
+#include "TelemetrySegment.hpp"
+#include <list>
 #include <memory>
 #include <string>
 #include <systemc>
@@ -45,10 +49,51 @@ public:
   registerState(const std::string moduleName,
                 std::shared_ptr<PowerModelStateBase> statePtr) override;
 
+  virtual void registerStateTransition(const unsigned int fromStateId,
+                                       const unsigned int toStateId,
+                                       const double energy,
+                                       const sc_core::sc_time &latency =
+                                           sc_core::SC_ZERO_TIME) override;
+
+  virtual sc_core::sc_time
+  getStateTransitionLatency(const unsigned int fromStateId,
+                            const unsigned int toStateId) const override;
+
   virtual void reportEvent(const unsigned int eventId, const unsigned int n = 1) override;
 
+  virtual void reportEvent(const unsigned int eventId, const unsigned int n,
+                           const sc_core::sc_time &localOffset) override;
+
+  virtual void reportHistoryEvent(const unsigned int eventId,
+                                  const unsigned int symbol,
+                                  const unsigned int n = 1) override;
+
+  virtual void reportDataEvent(const unsigned int eventId,
+                               const uint64_t prevData, const uint64_t newData,
+                               const unsigned int width = 64) override;
+
+  virtual void reportDataEvent(const unsigned int eventId,
+                               const uint64_t *prevData,
+                               const uint64_t *newData,
+                               const unsigned int width) override;
+
+  virtual void reportDataBurst(const unsigned int eventId,
+                               const uint64_t *prevData, const uint64_t *beats,
+                               const unsigned int nBeats,
+                               const unsigned int width) override;
+
+  virtual void
+  reportEvents(const std::vector<PowerModelEventCount> &counts) override;
+
+  virtual double getEventEnergy(const unsigned int eventId) const override;
+
   virtual void reportState(const unsigned int stateId) override;
 
+  virtual void scheduleState(const unsigned int stateId,
+                             const sc_core::sc_time &delay) override;
+
+  virtual void cancelScheduledStates(const unsigned int stateId) override;
+
   virtual int popEventCount(const unsigned int eventId) override;
 
   virtual double popEventEnergy(const unsigned int eventId) override;
@@ -59,6 +104,15 @@ public:
 
   virtual void getDynamicPower() override;
 
+  virtual unsigned int registerContext(const std::string contextName) override;
+
+  virtual void setContext(const unsigned int contextId) override;
+
+  virtual double getContextEnergy(const unsigned int contextId) override;
+
+  virtual double getContextEventEnergy(const unsigned int contextId,
+                                       const unsigned int eventId) override;
+
   virtual const sc_core::sc_event &supplyVoltageChangedEvent() const override {
     return m_supplyVoltageChangedEvent;
   }
@@ -67,6 +121,132 @@ public:
 
   virtual void setSupplyVoltage(double val) override;
 
+  virtual void setSupplyVoltage(const unsigned int domainId,
+                                const double val) override;
+
+  virtual double getSupplyVoltage(const unsigned int domainId) const override;
+
+  /**
+   * @brief addVoltageDomain add a supply voltage domain, e.g. for modules
+   * behind their own regulator or level shifter. Domain 0 is the channel's
+   * own supply. Must be called during elaboration.
+   * @param domainName name of the domain
+   * @retval domain id
+   */
+  unsigned int addVoltageDomain(const std::string domainName);
+
+  /**
+   * @brief setOperatingPoint switch a voltage domain to a DVFS operating
+   * point. All operating point tables used by the domain's modules select
+   * the point, which only swaps their row pointers, and the domain's supply
+   * voltage is set to the point's voltage. Can not be combined with voltage
+   * quantization in domain 0.
+   *
+   * All tables used within a domain must have the same operating points, and
+   * a table can only be used by one domain, as it has a single selected
+   * point. Both are checked at start of simulation, and throw
+   * std::invalid_argument.
+   * @param point index of the operating point, see OperatingPointTable
+   * @param domainId id of the domain, 0 for the channel's own supply
+   */
+  void setOperatingPoint(const unsigned int point,
+                         const unsigned int domainId = 0);
+
+  /**
+   * @brief setModuleDomain move a registered module into a voltage domain.
+   * Its events and states are evaluated at the domain's supply voltage from
+   * then on. Must be called during elaboration.
+   * @param moduleName name of the module, as passed to registerEvent or
+   * registerState
+   * @param domainId id of the domain, as obtained from addVoltageDomain
+   */
+  void setModuleDomain(const std::string moduleName,
+                       const unsigned int domainId);
+
+  virtual int getModuleId(const std::string moduleName) const override;
+
+  virtual double getModuleEnergy(const unsigned int moduleId) override;
+
+  virtual void refreshStateCurrents(const unsigned int moduleId) override;
+
+  virtual double getEventEnergyTotal(const unsigned int eventId) const override;
+
+  virtual double getTotalEnergy() override;
+
+  virtual int registerPowerWatcher(const double threshold) override;
+
+  virtual int registerEnergyWatcher(const double threshold) override;
+
+  virtual void rearmWatcher(const unsigned int watcherId) override;
+
+  virtual const sc_core::sc_event &
+  watcherEvent(const unsigned int watcherId) const override;
+
+  /**
+   * @brief setTemporalDecoupling configure the accounting of events reported
+   * with a local time offset. Such events are binned into intervals of length
+   * resolution, and held in a ring of pending intervals until simulation time
+   * has passed them. Offsets beyond the ring are clamped to its last interval.
+   * The resolution should divide both the log timestep and the power model
+   * timestep. Defaults to the log timestep and 16 intervals; channels without
+   * a log timestep count offset reports immediately, with a warning, unless
+   * this is called. Must be called during elaboration.
+   * @param resolution interval length, SC_ZERO_TIME to ignore offsets
+   * @param horizon number of pending intervals, i.e. the largest offset is
+   * about horizon * resolution
+   */
+  void setTemporalDecoupling(const sc_core::sc_time &resolution,
+                             const unsigned int horizon = 16);
+
+  /**
+   * @brief setVoltageQuantization enable supply voltage quantization. Supply
+   * voltages are rounded to a multiple of step, and the quantized voltage only
+   * moves to a new bucket once the supply voltage leaves the present bucket by
+   * more than the hysteresis. Voltage changes within a bucket are ignored: they
+   * neither re-evaluate the models nor trigger supplyVoltageChangedEvent.
+   *
+   * Event energies and state currents are evaluated once per bucket and kept
+   * in a cache of the cacheSize most recently used buckets. This assumes that
+   * they only depend on the supply voltage.
+   *
+   * The voltage seen by the models deviates from the supply voltage by at most
+   * getQuantizationErrorBound(). Should be called during elaboration.
+   * @param step quantization step in volts, or 0 to disable quantization
+   * @param hysteresis hysteresis in volts
+   * @param cacheSize number of buckets kept in the cache
+   */
+  void setVoltageQuantization(const double step, const double hysteresis = 0.0,
+                              const unsigned int cacheSize = 8);
+
+  //! Maximum deviation of the quantized from the actual supply voltage
+  double getQuantizationErrorBound() const {
+    return m_quantizationStep > 0.0
+               ? 0.5 * m_quantizationStep + m_quantizationHysteresis
+               : 0.0;
+  }
+
+  //! Largest deviation of the quantized from the actual supply voltage so far
+  double getMaxQuantizationError() const { return m_maxQuantizationError; }
+
+  //! Number of offset reports clamped to the decoupling horizon so far
+  uint64_t getClampedOffsetReports() const { return m_clampedOffsetReports; }
+
+  //! Number of offset reports counted immediately for lack of a resolution
+  uint64_t getIgnoredOffsetReports() const { return m_ignoredOffsetReports; }
+
+  /**
+   * @brief enableTelemetry publish live power telemetry to the POSIX
+   * shared-memory segment "/<segmentName>", see TelemetrySegment.hpp. Each
+   * period, the simulation time, supply voltage, static and dynamic power,
+   * total energy and the power of each module are published. Module dynamic
+   * power is based on the event energy popped during the period. Must be
+   * called during elaboration.
+   * @param segmentName name of the segment, without the leading '/'
+   * @param period publishing period, defaults to the log timestep
+   */
+  void enableTelemetry(const std::string &segmentName,
+                       const sc_core::sc_time &period = sc_core::SC_ZERO_TIME);
+
   /**
    * @brief start_of_simulation systemc callback. Used here to initialize the
    * internal event log.
@@ -100,11 +280,31 @@ private:
   //! Keeps track of event counts since the last pop
   std::vector<int> m_eventRates;
 
+  //! State machine of a history-dependent event, pointing into the tables of
+  //! its HistoryEnergyEvent so it can be stepped without virtual calls
+  struct HistoryTable {
+    unsigned int nSymbols;
+    const uint8_t *next;
+    const double *energy;
+    unsigned int state;
+    //! Energy and number of the occurrences stepped since the last pop
+    double pendingEnergy;
+    unsigned int pendingCount;
+  };
+  std::vector<HistoryTable> m_historyTables;
+
+  //! Index into m_historyTables, or -1 for plain events. The index is the
+  //! event id.
+  std::vector<int> m_historyIndex;
+
   // ------ States ------
   //! Struct for storing state objects and their module ids
   struct ModuleStateEntry {
     std::shared_ptr<PowerModelStateBase> state;
     const unsigned int moduleId;
+    //! Current depends on more than the supply voltage, so it is not taken
+    //! from the voltage quantization tables
+    bool uncached = false;
     ModuleStateEntry(std::shared_ptr<PowerModelStateBase> &&state_,
                      const unsigned int id)
         : state(std::move(state_)), moduleId(id) {}
@@ -118,15 +318,241 @@ private:
   //! module. The index is the module id and the value is the state id.
   std::vector<int> m_currentStates;
 
+  //! Lookup table banks used by registered events and states. Each bank is
+  //! re-interpolated once per supply voltage change.
+  std::vector<std::shared_ptr<LookupTableBank>> m_lookupTableBanks;
+
+  //! Operating point tables used by registered events and states, and the
+  //! module using them
+  struct OperatingPointUse {
+    std::shared_ptr<OperatingPointTable> table;
+    unsigned int moduleId;
+  };
+  std::vector<OperatingPointUse> m_operatingPointTables;
+
+  //! Distinct operating point tables of each domain. The index is the domain
+  //! id. Built by buildOperatingPointDomains.
+  std::vector<std::vector<OperatingPointTable *>> m_domainOperatingPoints;
+
+  // ------ Temporal decoupling ------
+  //! Length of a pending interval
+  sc_core::sc_time m_decouplingResolution{sc_core::SC_ZERO_TIME};
+
+  //! Number of pending intervals in the ring
+  unsigned int m_decouplingHorizon = 16;
+
+  //! Whether setTemporalDecoupling was called, otherwise the resolution
+  //! defaults to the log timestep
+  bool m_decouplingConfigured = false;
+
+  //! Offset reports clamped to the horizon, and offset reports counted
+  //! immediately because there is no resolution. Warned about once.
+  uint64_t m_clampedOffsetReports = 0;
+  uint64_t m_ignoredOffsetReports = 0;
+
+  //! Pending event counts, m_pendingEvents[slot * m_events.size() + eventId],
+  //! where the slot of interval k is k % m_decouplingHorizon
+  std::vector<unsigned int> m_pendingEvents;
+
+  //! Index of the oldest interval that may hold pending counts
+  uint64_t m_pendingBase = 0;
+
+  //! Sum of all pending counts
+  uint64_t m_pendingTotal = 0;
+
+  // ------ Voltage domains ------
+  //! Domain names and supply voltages, the index is the domain id. Domain 0
+  //! is the channel's own supply, m_domainVoltages[0] == m_supplyVoltage.
+  std::vector<std::string> m_domainNames{"default"};
+  std::vector<double> m_domainVoltages{0.0};
+
+  //! Domain of each module. The index is the module id.
+  std::vector<unsigned int> m_moduleDomain;
+
+  //! Module ids ordered by domain, the modules of domain d are
+  //! m_domainModules[m_domainStart[d], m_domainStart[d + 1])
+  std::vector<unsigned int> m_domainModules;
+  std::vector<unsigned int> m_domainStart{0, 0};
+
+  // ------ Voltage quantization ------
+  //! Event energies and state currents evaluated at one quantized voltage
+  struct VoltageTables {
+    long bucket;
+    std::vector<double> eventEnergy;
+    std::vector<double> stateCurrent;
+  };
+
+  //! Quantization step, 0 if quantization is disabled
+  double m_quantizationStep = 0.0;
+  double m_quantizationHysteresis = 0.0;
+  unsigned int m_voltageTableCacheSize = 0;
+  double m_maxQuantizationError = 0.0;
+
+  //! Cached tables, most recently used first
+  std::list<VoltageTables> m_voltageTableCache;
+
+  //! Tables of the present bucket, or nullptr if not quantizing
+  const VoltageTables *m_voltageTables = nullptr;
+
+  // ------ State transitions ------
+  //! Transition as registered, before densification
+  struct StateTransition {
+    unsigned int from;
+    unsigned int to;
+    double energy;
+    sc_core::sc_time latency;
+  };
+  std::vector<StateTransition> m_stateTransitions;
+
+  //! Index of each state among its module's states. The index is the state id.
+  std::vector<unsigned int> m_stateLocalIndex;
+
+  //! Number of states of each module. The index is the module id.
+  std::vector<unsigned int> m_moduleStateCount;
+
+  //! Offset of each module's transition matrix in m_transitionEnergy and
+  //! m_transitionLatency, or -1 if it has no transitions. Matrices are
+  //! row-major, [from][to] by local state index.
+  std::vector<long> m_transitionOffset;
+  std::vector<double> m_transitionEnergy;
+  std::vector<sc_core::sc_time> m_transitionLatency;
+
+  //! Transition energy charged since the last popDynamicEnergy
+  double m_pendingTransitionEnergy = 0.0;
+
+  // ------ Scheduled states ------
+  //! A state transition scheduled with scheduleState
+  struct ScheduledState {
+    sc_core::sc_time time;
+    //! Order of scheduling, breaks ties between equal times
+    uint64_t sequence;
+    unsigned int stateId;
+    //! Generation of the module's schedule at scheduling time
+    uint32_t generation;
+    bool operator>(const ScheduledState &other) const {
+      return time != other.time ? time > other.time
+                                : sequence > other.sequence;
+    }
+  };
+
+  //! Min-heap of scheduled transitions of all modules, served by a single
+  //! process
+  std::vector<ScheduledState> m_scheduledStates;
+  uint64_t m_scheduleSequence = 0;
+
+  //! Per-module schedule generation. Cancelling increments it, which
+  //! invalidates the module's pending transitions without searching the heap.
+  std::vector<uint32_t> m_scheduleGenerations;
+
+  sc_core::sc_event m_scheduledStateEvent{"scheduledStateEvent"};
+
+  // ------ Contexts ------
+  //! Energy attributed to a software context
+  struct Context {
+    std::string name;
+    //! Event counts since the last fold, allocated on first activation. The
+    //! index is the event id.
+    std::vector<uint64_t> counts;
+    //! Folded energy per event, allocated with counts
+    std::vector<double> eventEnergy;
+    //! Folded event energy and transition energy
+    double dynamicEnergy = 0.0;
+    double staticEnergy = 0.0;
+    explicit Context(const std::string &name_) : name(name_) {}
+  };
+
+  //! Registered contexts. The index is the context id.
+  std::vector<Context> m_contexts{Context("default")};
+
+  //! Current context, and its counts
+  unsigned int m_context = 0;
+  uint64_t *m_contextCounts = nullptr;
+
+  //! m_totalStaticEnergy at the last context switch
+  double m_contextStaticMark = 0.0;
+
+  // ------ Energy accounting ------
+  //! Energy of all popped occurrences of each event. The index is the event
+  //! id.
+  std::vector<double> m_eventEnergyTotals;
+
+  //! Popped event energy of each module. The index is the module id.
+  std::vector<double> m_moduleDynamicEnergy;
+
+  //! State energy of each module, integrated up to m_moduleStaticTime.
+  std::vector<double> m_moduleStaticEnergy;
+
+  //! Current drawn by each module in its present state at the present supply
+  //! voltage. Refreshed on state changes, voltage changes and static current
+  //! reads.
+  std::vector<double> m_moduleCurrents;
+
+  //! Time up to which each module's state energy has been integrated.
+  std::vector<sc_core::sc_time> m_moduleStaticTime;
+
+  //! Sum of the per-module event energy
+  double m_totalDynamicEnergy = 0.0;
+
+  //! State energy of all modules, integrated up to m_staticTime. Kept
+  //! separately from the per-module integrals so the total is O(1) to update.
+  double m_totalStaticEnergy = 0.0;
+
+  //! Sum of m_moduleCurrents of each domain. The index is the domain id.
+  std::vector<double> m_domainCurrents{0.0};
+
+  //! Time up to which m_totalStaticEnergy has been integrated
+  sc_core::sc_time m_staticTime{sc_core::SC_ZERO_TIME};
+
+  //! Average event power over the last popDynamicEnergy interval
+  double m_dynamicPower = 0.0;
+
+  //! Time of the last call to popDynamicEnergy
+  sc_core::sc_time m_lastPopTime{sc_core::SC_ZERO_TIME};
+
+  // ------ Watchers ------
+  //! Struct for storing power and energy watchers
+  struct Watcher {
+    double threshold;
+    bool isEnergyWatcher;
+    bool armed = true;
+    //! Total energy at the last (re-)arm, only used by energy watchers
+    double checkpoint = 0.0;
+    //! Whether a timed notification for a predicted crossing is pending
+    bool scheduled = false;
+    sc_core::sc_time crossingTime{sc_core::SC_ZERO_TIME};
+    std::unique_ptr<sc_core::sc_event> event{new sc_core::sc_event()};
+    Watcher(const double threshold_, const bool isEnergyWatcher_)
+        : threshold(threshold_), isEnergyWatcher(isEnergyWatcher_) {}
+  };
+
+  //! Stores registered watchers. The index corresponds to the watcher id.
+  std::vector<Watcher> m_watchers;
+
   // ------ Logging ------
   std::string m_eventLogFileName;
   std::string m_stateLogFileName;
   std::string m_staticPowerLogFileName;
   std::string m_eventPowerLogFileName;
+  std::string m_energyReportFileName;
 
   //! Log file timestep
   sc_core::sc_time m_logTimestep;
 
+  // ------ Telemetry ------
+  //! Name of the telemetry segment, empty if telemetry is disabled
+  std::string m_telemetryName;
+  sc_core::sc_time m_telemetryPeriod{sc_core::SC_ZERO_TIME};
+  std::unique_ptr<TelemetryWriter> m_telemetry;
+
+  //! m_moduleDynamicEnergy at the last publish
+  std::vector<double> m_telemetryEnergy;
+
+  //! Time of the last publish
+  sc_core::sc_time m_telemetryTime{sc_core::SC_ZERO_TIME};
+
+  //! Reused snapshot buffer
+  TelemetrySnapshot m_telemetrySnapshot;
+
   //! Keeps log of event counts in the form:
   //! count0 count1 ... countN TIME0(microseconds)
   //! count0 count1 ... countN TIME1(microseconds)
@@ -171,6 +597,195 @@ private:
 
   void dumpEventPowerCsv();
 
+  /**
+   * @brief dumpEnergyReport write the per-module and per-event energy
+   * breakdown to a csv. Called once, at the end of simulation.
+   */
+  void dumpEnergyReport();
+
+  /**
+   * @brief addModule add a new module entry and size its per-module state.
+   * @param moduleName name of the module
+   * @retval id of the new module
+   */
+  unsigned int addModule(const std::string &moduleName);
+
+  /**
+   * @brief drainPendingEvents add the pending counts of all intervals that
+   * ended before the present time to the event counts and log.
+   * @param all drain all intervals, e.g. at the end of simulation
+   */
+  void drainPendingEvents(const bool all = false);
+
+  /**
+   * @brief addLookupTableBank add a bank to m_lookupTableBanks, unless it is
+   * already there.
+   */
+  void addLookupTableBank(const std::shared_ptr<LookupTableBank> &bank);
+
+  //! Add a table to m_operatingPointTables, unless it is already there for
+  //! the module
+  void addOperatingPointTable(const std::shared_ptr<OperatingPointTable> &table,
+                              const unsigned int moduleId);
+
+  /**
+   * @brief buildOperatingPointDomains group the operating point tables by
+   * domain into m_domainOperatingPoints, and check that tables are not
+   * shared between domains and agree on the operating points within one.
+   */
+  void buildOperatingPointDomains();
+
+  //! Re-interpolate all lookup table banks at the present supply voltage
+  void updateLookupTables();
+
+  /**
+   * @brief checkLookupTableDomains check that lookup table models are only
+   * used by modules in domain 0. Banks are interpolated at the main supply
+   * voltage, other domains would re-interpolate them on every evaluation.
+   */
+  void checkLookupTableDomains() const;
+
+  /**
+   * @brief selectVoltageTables point m_voltageTables to the tables of a
+   * bucket, evaluating them at the present supply voltage on a cache miss.
+   */
+  void selectVoltageTables(const long bucket);
+
+  //! Energy of one occurrence of an event at its domain's present voltage
+  double eventEnergy(const unsigned int eventId) const {
+    const auto &e = m_events[eventId];
+    const auto domain = m_moduleDomain[e.moduleId];
+    if (domain != 0) {
+      return e.event->calculateEnergy(m_domainVoltages[domain]);
+    }
+    return m_voltageTables != nullptr
+               ? m_voltageTables->eventEnergy[eventId]
+               : e.event->calculateEnergy(m_supplyVoltage);
+  }
+
+  //! Current of a state at its domain's present voltage
+  double stateCurrent(const unsigned int stateId) const {
+    const auto &s = m_states[stateId];
+    const auto domain = m_moduleDomain[s.moduleId];
+    if (domain != 0) {
+      return s.state->calculateCurrent(m_domainVoltages[domain]);
+    }
+    return m_voltageTables != nullptr && !s.uncached
+               ? m_voltageTables->stateCurrent[stateId]
+               : s.state->calculateCurrent(m_supplyVoltage);
+  }
+
+  //! Supply voltage of a module's domain
+  double moduleVoltage(const unsigned int moduleId) const {
+    return m_domainVoltages[m_moduleDomain[moduleId]];
+  }
+
+  //! Present state power of all modules, summed over the domains
+  double staticPower() const {
+    double p = 0.0;
+    for (unsigned int d = 0; d < m_domainVoltages.size(); ++d) {
+      p += m_domainVoltages[d] * m_domainCurrents[d];
+    }
+    return p;
+  }
+
+  /**
+   * @brief buildDomainRanges sort the module ids by domain into
+   * m_domainModules. Called whenever a module is added or moved.
+   */
+  void buildDomainRanges();
+
+  /**
+   * @brief integrateStaticEnergy accumulate a module's state energy from the
+   * last integration point up to the current simulation time.
+   * @param moduleId id of the module
+   */
+  void integrateStaticEnergy(const unsigned int moduleId);
+
+  /**
+   * @brief updateModuleCurrent integrate a module's state energy and then
+   * re-evaluate the current drawn in its present state.
+   * @param moduleId id of the module
+   */
+  void updateModuleCurrent(const unsigned int moduleId);
+
+  /**
+   * @brief integrateTotalStaticEnergy accumulate the state energy of all
+   * modules from the last integration point up to the current simulation time.
+   */
+  void integrateTotalStaticEnergy();
+
+  /**
+   * @brief takeEventCount take and reset an event's count, after draining
+   * pending decoupled events. Unlike popEventCount, this leaves the pending
+   * energy of history-dependent events for accumulateEventEnergy.
+   */
+  unsigned int takeEventCount(const unsigned int eventId);
+
+  /**
+   * @brief accumulateEventEnergy pop an event's count and add its energy to
+   * the energy totals.
+   * @param eventId id of the event
+   * @retval energy of the popped occurrences
+   */
+  double accumulateEventEnergy(const unsigned int eventId);
+
+  //! Count n occurrences of an event, without stepping history state machines
+  void countEvent(const unsigned int eventId, const unsigned int n);
+
+  /**
+   * @brief stepHistoryEvent step the state machine of a history-dependent
+   * event n times with symbol, and add the energy of the occurrences to its
+   * pending energy. Plain reports step it with symbol 0.
+   */
+  void stepHistoryEvent(const unsigned int eventId, const unsigned int symbol,
+                        const unsigned int n);
+
+  /**
+   * @brief popHistoryEnergy pending energy of the n popped occurrences of a
+   * history-dependent event, all of which have been stepped when reported.
+   */
+  double popHistoryEnergy(const unsigned int eventId, const unsigned int n);
+
+  //! Allocate the current context's counts if needed, and point
+  //! m_contextCounts to them
+  void activateContext();
+
+  //! Attribute the state energy since the last context switch to the current
+  //! context
+  void chargeContextStaticEnergy();
+
+  /**
+   * @brief foldContextCounts convert the event counts of all contexts to
+   * energy at the present supply voltage. Called before the voltage changes.
+   */
+  void foldContextCounts();
+
+  /**
+   * @brief checkWatchers compare the power and energy totals against the
+   * registered watchers, and notify or schedule their events. Called whenever
+   * the totals change.
+   */
+  void checkWatchers();
+
+  /**
+   * @brief buildTransitionMatrices densify the registered state transitions
+   * into one matrix per module. Called at start of simulation.
+   */
+  void buildTransitionMatrices();
+
+  /**
+   * @brief scheduledStateProcess SC_METHOD that applies due scheduled
+   * transitions, and waits for the next one.
+   */
+  void scheduledStateProcess();
+
+  /**
+   * @brief telemetryProcess SC_METHOD that publishes a telemetry snapshot
+   * every telemetry period.
+   */
+  void telemetryProcess();
+
   /**
    * @brief logLoop systemc thread that records event counts at a specified
    * timestep. The event counts for logging are unaffected reset by the
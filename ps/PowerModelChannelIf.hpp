@@ -7,8 +7,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <systemc>
+#include <vector>
 #include "PowerModelEventBase.hpp"
 #include "PowerModelStateBase.hpp"
 
@@ -28,6 +30,12 @@
  *
  */
 
+//! Number of occurrences of an event, for batched reporting
+struct PowerModelEventCount {
+  unsigned int eventId;
+  unsigned int n;
+};
+
 /**
  * @brief class PowerModelChannelOutIf output interface. This is used
  * by modules to register and report their events and states for power
@@ -60,6 +68,31 @@ class PowerModelChannelOutIf : public virtual sc_core::sc_interface {
   virtual int registerState(const std::string moduleName,
                             std::shared_ptr<PowerModelStateBase> statePtr) = 0;
 
+  /**
+   * @brief registerStateTransition register the energy and latency of a
+   * module's transition between two of its states. The energy is charged
+   * (as dynamic energy) whenever reportState switches the module from one
+   * state to the other. Transitions must be registered before simulation
+   * starts; unregistered transitions cost nothing.
+   * @param fromStateId, toStateId ids of two states of the same module
+   * @param energy transition energy in joules
+   * @param latency transition latency, see getStateTransitionLatency
+   */
+  virtual void registerStateTransition(const unsigned int fromStateId,
+                                       const unsigned int toStateId,
+                                       const double energy,
+                                       const sc_core::sc_time &latency =
+                                           sc_core::SC_ZERO_TIME) = 0;
+
+  /**
+   * @brief getStateTransitionLatency get the registered latency of a state
+   * transition, e.g. to schedule the end of a wake-up with scheduleState.
+   * @retval latency, or SC_ZERO_TIME if the transition is not registered
+   */
+  virtual sc_core::sc_time
+  getStateTransitionLatency(const unsigned int fromStateId,
+                            const unsigned int toStateId) const = 0;
+
   /**
    * @brief reportEvent notify the channel of n occurrences of a specific event.
    * The internal count of the channel is cumulative, so each write adds to an
@@ -69,6 +102,86 @@ class PowerModelChannelOutIf : public virtual sc_core::sc_interface {
    */
   virtual void reportEvent(const unsigned int eventId, const unsigned int n = 1) = 0;
 
+  /**
+   * @brief reportEvent notify the channel of n occurrences of a specific event
+   * at a local time offset, for temporally decoupled (loosely-timed) models
+   * that run ahead of the simulation time. The occurrences are accounted for
+   * in the log interval and power model timestep that contain
+   * sc_time_stamp() + localOffset.
+   * @param eventId id of the event, as obtained from registerEvent
+   * @param n number of occurrences
+   * @param localOffset local time offset, e.g. from
+   * tlm_utils::tlm_quantumkeeper::get_local_time()
+   */
+  virtual void reportEvent(const unsigned int eventId, const unsigned int n,
+                           const sc_core::sc_time &localOffset) = 0;
+
+  /**
+   * @brief reportHistoryEvent notify the channel of n occurrences of a
+   * history-dependent event (see HistoryEnergyEvent) with a given symbol.
+   * @param eventId id of the event, as obtained from registerEvent
+   * @param symbol symbol of the occurrences
+   * @param n number of occurrences
+   */
+  virtual void reportHistoryEvent(const unsigned int eventId,
+                                  const unsigned int symbol,
+                                  const unsigned int n = 1) = 0;
+
+  /**
+   * @brief reportDataEvent notify the channel of a data-dependent event, e.g.
+   * a bus or register write, whose energy scales with the number of toggled
+   * bits. The event is counted once per bit that differs between the old and
+   * the new value, so its energy is the energy per toggle.
+   * @param eventId id of the event, as obtained from registerEvent
+   * @param prevData previous value
+   * @param newData new value
+   * @param width width of the values in bits, at most 64
+   */
+  virtual void reportDataEvent(const unsigned int eventId,
+                               const uint64_t prevData, const uint64_t newData,
+                               const unsigned int width = 64) = 0;
+
+  /**
+   * @brief reportDataEvent as above, for values wider than 64 bits.
+   * @param prevData, newData values, (width + 63) / 64 words each, least
+   * significant word first
+   * @param width width of the values in bits
+   */
+  virtual void reportDataEvent(const unsigned int eventId,
+                               const uint64_t *prevData,
+                               const uint64_t *newData,
+                               const unsigned int width) = 0;
+
+  /**
+   * @brief reportDataBurst notify the channel of a burst of data-dependent
+   * events on the same lines, counting the toggles between successive beats.
+   * @param eventId id of the event, as obtained from registerEvent
+   * @param prevData value on the lines before the burst
+   * @param beats nBeats values, (width + 63) / 64 words each, back to back
+   * @param nBeats number of beats
+   * @param width width of the values in bits
+   */
+  virtual void reportDataBurst(const unsigned int eventId,
+                               const uint64_t *prevData, const uint64_t *beats,
+                               const unsigned int nBeats,
+                               const unsigned int width) = 0;
+
+  /**
+   * @brief reportEvents notify the channel of occurrences of several events
+   * in one call. Equivalent to calling reportEvent for each entry.
+   * @param counts event ids and numbers of occurrences
+   */
+  virtual void
+  reportEvents(const std::vector<PowerModelEventCount> &counts) = 0;
+
+  /**
+   * @brief getEventEnergy get the energy of one occurrence of an event at the
+   * present supply voltage.
+   * @param eventId id of the event, as obtained from registerEvent
+   * @retval event energy in joules.
+   */
+  virtual double getEventEnergy(const unsigned int eventId) const = 0;
+
   /**
    * @brief reportState notify the channel of the current state of a module.
    * This method can be called regardless of whether the module state has
@@ -77,18 +190,165 @@ class PowerModelChannelOutIf : public virtual sc_core::sc_interface {
    */
   virtual void reportState(const unsigned int stateId) = 0;
 
+  /**
+   * @brief scheduleState report a module state after a delay, e.g. for
+   * power-down timers and wake-up latencies, without a thread in the module.
+   * Transitions scheduled for the same time are applied in the order they
+   * were scheduled.
+   * @param stateId id of the module state, as obtained from registerState
+   * @param delay time from now at which the state is reported
+   */
+  virtual void scheduleState(const unsigned int stateId,
+                             const sc_core::sc_time &delay) = 0;
+
+  /**
+   * @brief cancelScheduledStates cancel all pending scheduled transitions of
+   * a module. Transitions reported directly with reportState do not cancel
+   * scheduled ones.
+   * @param stateId id of any state of the module
+   */
+  virtual void cancelScheduledStates(const unsigned int stateId) = 0;
+
+  /**
+   * @brief registerContext register a software context, e.g. an RTOS task or
+   * a function, for energy attribution. Contexts can be registered at any
+   * time. Context 0 ("default") is always registered.
+   * @param contextName name of the context
+   * @retval assigned context id, or the existing id if the name is already
+   * registered
+   */
+  virtual unsigned int registerContext(const std::string contextName) = 0;
+
+  /**
+   * @brief setContext switch the current context, e.g. on a task switch.
+   * Events reported and state energy consumed from now on are attributed to
+   * this context, until the next switch.
+   * @param contextId id of the context, as obtained from registerContext
+   */
+  virtual void setContext(const unsigned int contextId) = 0;
+
+  /**
+   * @brief getContextEnergy get the energy attributed to a context so far.
+   * Event energy is evaluated at the supply voltage of the time of the
+   * report. History-dependent events are charged the energy of the step
+   * they take, to the context current when they are stepped.
+   * @param contextId id of the context, as obtained from registerContext
+   * @retval event, transition and state energy of the context in joules.
+   */
+  virtual double getContextEnergy(const unsigned int contextId) = 0;
+
+  /**
+   * @brief getContextEventEnergy get the energy of one event attributed to a
+   * context so far, evaluated as for getContextEnergy.
+   * @param contextId id of the context, as obtained from registerContext
+   * @param eventId id of the event, as obtained from registerEvent
+   * @retval energy of the event's occurrences in the context in joules.
+   */
+  virtual double getContextEventEnergy(const unsigned int contextId,
+                                       const unsigned int eventId) = 0;
+
   /**
    * @brief getSupplyVoltage get the current supply voltage.
    * @retval current supply voltage in volts.
    */
   virtual double getSupplyVoltage() const = 0;
 
+  /**
+   * @brief getSupplyVoltage get the current supply voltage of a voltage
+   * domain. Domain 0 is the channel's own supply.
+   * @param domainId id of the domain
+   * @retval current supply voltage of the domain in volts.
+   */
+  virtual double getSupplyVoltage(const unsigned int domainId) const = 0;
+
   /**
    * @brief supplyVoltageChangedEvent get supplyVoltageChanged event.
    * @retval supplyVoltageChanged event, an event that triggers whenever the
    * supply voltage has changed.
    */
   virtual const sc_core::sc_event& supplyVoltageChangedEvent() const = 0;
+
+  /**
+   * @brief getModuleId get the id the channel assigned to a module when it
+   * first registered an event or state.
+   * @param moduleName name of the module, as passed to registerEvent or
+   * registerState
+   * @retval module id, or -1 if no module with that name is registered.
+   */
+  virtual int getModuleId(const std::string moduleName) const = 0;
+
+  /**
+   * @brief getModuleEnergy get the energy consumed by a module so far. This
+   * is the sum of the energy of its popped events and its state energy
+   * integrated up to the current simulation time.
+   * @param moduleId id of the module, as obtained from getModuleId
+   * @retval energy consumed by the module in joules.
+   */
+  virtual double getModuleEnergy(const unsigned int moduleId) = 0;
+
+  /**
+   * @brief refreshStateCurrents re-evaluate the current of a module's present
+   * state, after something other than the supply voltage changed it, e.g.
+   * the temperature of a LeakageCurrentState. State energy is integrated at
+   * the old current up to now. The module's states are evaluated directly
+   * from then on, rather than from the voltage quantization tables.
+   * @param moduleId id of the module, as obtained from getModuleId
+   */
+  virtual void refreshStateCurrents(const unsigned int moduleId) = 0;
+
+  /**
+   * @brief getEventEnergyTotal get the cumulated energy of an event. Event
+   * energy is accounted for when the event count is popped, i.e. once per
+   * power model timestep.
+   * @param eventId id of the event, as obtained from registerEvent
+   * @retval energy of all popped occurrences of the event in joules.
+   */
+  virtual double getEventEnergyTotal(const unsigned int eventId) const = 0;
+
+  /**
+   * @brief getTotalEnergy get the energy consumed by all modules so far.
+   * @retval sum of popped event energy and state energy in joules.
+   */
+  virtual double getTotalEnergy() = 0;
+
+  /**
+   * @brief registerPowerWatcher register a watcher that triggers its event
+   * whenever the channel's power consumption rises above a threshold. Power
+   * is the state power at the present supply voltage plus the average event
+   * power over the last popDynamicEnergy interval. The watcher re-arms once
+   * power drops back to or below the threshold. Watchers must be registered
+   * before simulation starts.
+   * @param threshold power threshold in watts
+   * @retval  assigned watcher id
+   */
+  virtual int registerPowerWatcher(const double threshold) = 0;
+
+  /**
+   * @brief registerEnergyWatcher register a watcher that triggers its event
+   * once when the energy consumed since its checkpoint reaches a threshold.
+   * The checkpoint is the start of simulation, or the last call to
+   * rearmWatcher. Crossings driven by state energy are predicted and notified
+   * at the exact crossing time. Watchers must be registered before simulation
+   * starts.
+   * @param threshold energy threshold in joules
+   * @retval  assigned watcher id
+   */
+  virtual int registerEnergyWatcher(const double threshold) = 0;
+
+  /**
+   * @brief rearmWatcher re-arm a watcher. For energy watchers, this also moves
+   * the checkpoint to the present total energy.
+   * @param watcherId id of the watcher, as obtained from register*Watcher
+   */
+  virtual void rearmWatcher(const unsigned int watcherId) = 0;
+
+  /**
+   * @brief watcherEvent get the event triggered by a watcher.
+   * @param watcherId id of the watcher, as obtained from register*Watcher
+   * @retval event that triggers when the watcher's threshold is crossed.
+   */
+  virtual const sc_core::sc_event &
+  watcherEvent(const unsigned int watcherId) const = 0;
 };
 
 /**
@@ -124,7 +384,9 @@ class PowerModelChannelInIf : public virtual sc_core::sc_interface {
 
   /**
    * @brief getStaticCurrent get the static current in this timestep as a sum of
-   * all module-state currents.
+   * all module-state currents. With several voltage domains, this is the
+   * current drawn from the channel's own supply assuming ideal conversion,
+   * i.e. the summed state power divided by the supply voltage.
    * */
   virtual double getStaticCurrent() = 0;
   // virtual void getDynamicEnergy() = 0;
@@ -135,6 +397,16 @@ class PowerModelChannelInIf : public virtual sc_core::sc_interface {
    * @param val current supply voltage in volts.
    */
   virtual void setSupplyVoltage(double val) = 0;
+
+  /**
+   * @brief setSupplyVoltage set the current supply voltage of a voltage
+   * domain. Only the modules of that domain are re-evaluated. Domain 0 is the
+   * channel's own supply, see setSupplyVoltage(val).
+   * @param domainId id of the domain
+   * @param val current supply voltage in volts.
+   */
+  virtual void setSupplyVoltage(const unsigned int domainId,
+                                const double val) = 0;
 };
 
 // Typedef of ports for convenience
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <systemc>
+
+/**
+ * @brief class PowerModelConsumerIf interface for consumers of a channel's
+ * power draw, e.g. native supply models. A bridge invokes consume
+ * synchronously once per timestep, instead of passing current and voltage
+ * through sc_signals, so closing the loop costs no delta cycles.
+ */
+class PowerModelConsumerIf {
+ public:
+  virtual ~PowerModelConsumerIf() {}
+
+  /**
+   * @brief consume process the power draw of the last timestep.
+   * @param time current simulation time
+   * @param staticCurrent state current in amperes
+   * @param dynamicEnergy event energy since the last call in joules
+   * @retval supply voltage in volts to apply to the channel
+   */
+  virtual double consume(const sc_core::sc_time &time,
+                         const double staticCurrent,
+                         const double dynamicEnergy) = 0;
+};
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/PowerModelDatabase.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+
+namespace {
+//! Header of a binary cache file, followed by `count` sorted entries
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t entrySize;
+  uint64_t sourceSize;
+  int64_t sourceMtimeSec;
+  int64_t sourceMtimeNsec;
+  uint64_t count;
+};
+
+const char cacheMagic[8] = {'F', 'U', 'S', 'E', 'D', 'P', 'M', 'D'};
+
+bool statSource(const std::string &path, struct stat &st) {
+  return ::stat(path.c_str(), &st) == 0;
+}
+
+void flatten(const YAML::Node &node, const std::string &prefix,
+             std::vector<PowerModelDatabase::Entry> &entries,
+             const std::string &yamlPath) {
+  if (node.IsMap()) {
+    for (const auto &kv : node) {
+      const auto key = kv.first.as<std::string>();
+      flatten(kv.second, prefix.empty() ? key : prefix + " " + key, entries,
+              yamlPath);
+    }
+  } else if (node.IsScalar()) {
+    double value;
+    try {
+      value = node.as<double>();
+    } catch (const YAML::Exception &e) {
+      throw std::invalid_argument(fmt::format(
+          "PowerModelDatabase::load '{:s}' in {:s} is not a number", prefix,
+          yamlPath));
+    }
+    entries.push_back({PowerModelDatabase::hash(prefix), value});
+  } else if (!node.IsNull()) {
+    throw std::invalid_argument(
+        fmt::format("PowerModelDatabase::load unsupported value for '{:s}' "
+                    "in {:s}",
+                    prefix, yamlPath));
+  }
+}
+} // namespace
+
+PowerModelDatabase &PowerModelDatabase::get() {
+  static PowerModelDatabase instance;
+  return instance;
+}
+
+PowerModelDatabase::~PowerModelDatabase() { clear(); }
+
+uint64_t PowerModelDatabase::hash(const std::string &key) {
+  uint64_t h = 14695981039346656037ull;
+  for (const auto c : key) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+void PowerModelDatabase::load(const std::string &yamlPath) {
+  const auto cachePath = yamlPath + ".pmdb";
+  Table table;
+  if (!mapCache(cachePath, yamlPath, table)) {
+    spdlog::info("PowerModelDatabase: parsing {:s}", yamlPath);
+    auto entries = parseYaml(yamlPath);
+    if (!writeCache(cachePath, yamlPath, entries) ||
+        !mapCache(cachePath, yamlPath, table)) {
+      spdlog::warn("PowerModelDatabase: can't write cache {:s}, keeping "
+                   "{:s} in memory",
+                   cachePath, yamlPath);
+      table.storage = std::move(entries);
+      table.entries = table.storage.data();
+      table.count = table.storage.size();
+    }
+  }
+  m_tables.push_back(std::move(table));
+}
+
+bool PowerModelDatabase::contains(const std::string &key) const {
+  return find(hash(key)) != nullptr;
+}
+
+double PowerModelDatabase::getDouble(const std::string &key) const {
+  const auto e = find(hash(key));
+  if (e == nullptr) {
+    throw std::out_of_range(fmt::format(
+        "PowerModelDatabase::getDouble key '{:s}' not found", key));
+  }
+  return e->value;
+}
+
+void PowerModelDatabase::set(const std::string &key, const double value) {
+  const uint64_t h = hash(key);
+  const auto it = std::lower_bound(
+      m_overrides.begin(), m_overrides.end(), h,
+      [](const Entry &e, const uint64_t val) { return e.hash < val; });
+  if (it != m_overrides.end() && it->hash == h) {
+    it->value = value;
+  } else {
+    m_overrides.insert(it, Entry{h, value});
+  }
+}
+
+void PowerModelDatabase::clear() {
+  for (auto &t : m_tables) {
+    if (t.map != nullptr) {
+      munmap(t.map, t.mapSize);
+    }
+  }
+  m_tables.clear();
+  m_overrides.clear();
+}
+
+size_t PowerModelDatabase::size() const {
+  size_t n = 0;
+  for (const auto &t : m_tables) {
+    n += t.count;
+  }
+  return n;
+}
+
+const PowerModelDatabase::Entry *
+PowerModelDatabase::find(const uint64_t h) const {
+  const auto o = std::lower_bound(
+      m_overrides.begin(), m_overrides.end(), h,
+      [](const Entry &e, const uint64_t val) { return e.hash < val; });
+  if (o != m_overrides.end() && o->hash == h) {
+    return &*o;
+  }
+  for (auto t = m_tables.rbegin(); t != m_tables.rend(); ++t) {
+    const auto end = t->entries + t->count;
+    const auto it = std::lower_bound(
+        t->entries, end, h,
+        [](const Entry &e, const uint64_t val) { return e.hash < val; });
+    if (it != end && it->hash == h) {
+      return it;
+    }
+  }
+  return nullptr;
+}
+
+bool PowerModelDatabase::mapCache(const std::string &cachePath,
+                                  const std::string &yamlPath, Table &table) {
+  struct stat src;
+  if (!statSource(yamlPath, src)) {
+    throw std::runtime_error(fmt::format(
+        "PowerModelDatabase::load can't open {:s}", yamlPath));
+  }
+
+  const int fd = ::open(cachePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(CacheHeader)) {
+    ::close(fd);
+    return false;
+  }
+  void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+
+  // Validate header against format version and source file
+  const auto hdr = static_cast<const CacheHeader *>(map);
+  const bool valid =
+      std::memcmp(hdr->magic, cacheMagic, sizeof(cacheMagic)) == 0 &&
+      hdr->version == cacheVersion && hdr->entrySize == sizeof(Entry) &&
+      hdr->sourceSize == static_cast<uint64_t>(src.st_size) &&
+      hdr->sourceMtimeSec == src.st_mtim.tv_sec &&
+      hdr->sourceMtimeNsec == src.st_mtim.tv_nsec &&
+      static_cast<size_t>(st.st_size) ==
+          sizeof(CacheHeader) + hdr->count * sizeof(Entry);
+  if (!valid) {
+    munmap(map, st.st_size);
+    return false;
+  }
+
+  table.map = map;
+  table.mapSize = st.st_size;
+  table.entries = reinterpret_cast<const Entry *>(
+      static_cast<const char *>(map) + sizeof(CacheHeader));
+  table.count = hdr->count;
+  return true;
+}
+
+std::vector<PowerModelDatabase::Entry>
+PowerModelDatabase::parseYaml(const std::string &yamlPath) {
+  std::vector<Entry> entries;
+  flatten(YAML::LoadFile(yamlPath), "", entries, yamlPath);
+
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry &a, const Entry &b) { return a.hash < b.hash; });
+  // Keys are unique within a YAML map, so equal hashes mean a collision
+  const auto dup = std::adjacent_find(
+      entries.begin(), entries.end(),
+      [](const Entry &a, const Entry &b) { return a.hash == b.hash; });
+  if (dup != entries.end()) {
+    throw std::runtime_error(fmt::format(
+        "PowerModelDatabase::load duplicate or colliding key in {:s}",
+        yamlPath));
+  }
+  return entries;
+}
+
+bool PowerModelDatabase::writeCache(const std::string &cachePath,
+                                    const std::string &yamlPath,
+                                    const std::vector<Entry> &entries) {
+  struct stat src;
+  if (!statSource(yamlPath, src)) {
+    return false;
+  }
+
+  CacheHeader hdr;
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr.magic, cacheMagic, sizeof(cacheMagic));
+  hdr.version = cacheVersion;
+  hdr.entrySize = sizeof(Entry);
+  hdr.sourceSize = src.st_size;
+  hdr.sourceMtimeSec = src.st_mtim.tv_sec;
+  hdr.sourceMtimeNsec = src.st_mtim.tv_nsec;
+  hdr.count = entries.size();
+
+  // Write to a temporary file and rename, so concurrent simulations never
+  // map a partially written cache
+  const auto tmpPath = fmt::format("{:s}.{:d}.tmp", cachePath, getpid());
+  {
+    std::ofstream f(tmpPath, std::ios::out | std::ios::binary |
+                                 std::ios::trunc);
+    if (!f.good()) {
+      return false;
+    }
+    f.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+    f.write(reinterpret_cast<const char *>(entries.data()),
+            entries.size() * sizeof(Entry));
+    if (!f.good()) {
+      std::remove(tmpPath.c_str());
+      return false;
+    }
+  }
+  return std::rename(tmpPath.c_str(), cachePath.c_str()) == 0;
+}
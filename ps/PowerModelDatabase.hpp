@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief PowerModelDatabase database of power model parameters, e.g. event
+ * energies and state currents, keyed by "<moduleName> <name>".
+ *
+ * Parameters are loaded from YAML files. Nested maps are flattened by joining
+ * their keys with a space, so the following are equivalent:
+ *
+ *   memory:
+ *     read: 5.0e-11      # event energy [J]
+ *     on: 1.0e-4         # state current [A]
+ *
+ *   "memory read": 5.0e-11
+ *   "memory on": 1.0e-4
+ *
+ * Each parsed file is cached next to it as a versioned binary table
+ * ("<file>.pmdb") of (key hash, value) entries sorted by hash. The cache is
+ * memory-mapped on later loads, as long as the YAML file's size and
+ * modification time are unchanged, so large databases are not reparsed on
+ * every simulation launch. Lookups are a binary search on the key hash.
+ *
+ * Single values can be overridden in memory with set(), e.g. per run of a
+ * parameter sweep (see SweepRunner).
+ *
+ * The database is a singleton, see get().
+ */
+class PowerModelDatabase {
+ public:
+  //! Binary cache format version. Bump when the layout changes.
+  static const uint32_t cacheVersion = 1;
+
+  //! Get the global database instance
+  static PowerModelDatabase &get();
+
+  //! Destructor, unmaps all caches
+  ~PowerModelDatabase();
+
+  PowerModelDatabase(const PowerModelDatabase &) = delete;
+  PowerModelDatabase &operator=(const PowerModelDatabase &) = delete;
+
+  /**
+   * @brief load load a YAML database file, from its binary cache if the cache
+   * is up to date. Entries of later loads take precedence over earlier ones.
+   * @param yamlPath path to the YAML file
+   */
+  void load(const std::string &yamlPath);
+
+  /**
+   * @brief contains check whether the database contains a key.
+   * @param key key of the form "<moduleName> <name>"
+   */
+  bool contains(const std::string &key) const;
+
+  /**
+   * @brief getDouble get the value of a key. Throws std::out_of_range if the
+   * key is not in the database.
+   * @param key key of the form "<moduleName> <name>"
+   */
+  double getDouble(const std::string &key) const;
+
+  /**
+   * @brief set override the value of a key, e.g. for a parameter sweep.
+   * Overrides take precedence over all loaded files.
+   * @param key key of the form "<moduleName> <name>"
+   * @param value new value
+   */
+  void set(const std::string &key, const double value);
+
+  //! Unload all files and drop all overrides
+  void clear();
+
+  //! Number of loaded entries, over all files
+  size_t size() const;
+
+  //! 64-bit FNV-1a hash used to index keys
+  static uint64_t hash(const std::string &key);
+
+  //! Entry of a cache table
+  struct Entry {
+    uint64_t hash;
+    double value;
+  };
+
+ private:
+  PowerModelDatabase() = default;
+
+  //! A loaded table, either memory-mapped from a cache or held in memory
+  struct Table {
+    const Entry *entries = nullptr;
+    size_t count = 0;
+    void *map = nullptr;
+    size_t mapSize = 0;
+    std::vector<Entry> storage;
+  };
+
+  /**
+   * @brief find look up a key hash, most recently loaded table first.
+   * @retval pointer to the entry, or nullptr if not found
+   */
+  const Entry *find(const uint64_t h) const;
+
+  //! Try to map an up-to-date cache file. Returns false if it is stale.
+  bool mapCache(const std::string &cachePath, const std::string &yamlPath,
+                Table &table);
+
+  //! Parse a YAML file into sorted entries
+  static std::vector<Entry> parseYaml(const std::string &yamlPath);
+
+  //! Write entries to a cache file. Returns false on failure.
+  static bool writeCache(const std::string &cachePath,
+                         const std::string &yamlPath,
+                         const std::vector<Entry> &entries);
+
+  std::vector<Table> m_tables;
+
+  //! Entries set with set(), sorted by hash
+  std::vector<Entry> m_overrides;
+};
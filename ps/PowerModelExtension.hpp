@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "PowerModelChannelIf.hpp"
+
+#include <systemc>
+#include <tlm>
+#include <vector>
+
+/**
+ * @brief PowerModelExtension generic payload extension that accumulates the
+ * power model events a transaction causes on its way through a system.
+ *
+ * The initiator attaches the extension and sets its initiator id. Each hop
+ * (interconnect, cache, memory, ...) appends its events with annotate()
+ * instead of reporting them to a channel itself. A PowerModelExtensionSink at
+ * the terminating target reports the accumulated events in one batch and
+ * writes the transaction's total energy back into the extension, where the
+ * initiator can read it when the transaction completes.
+ */
+class PowerModelExtension : public tlm::tlm_extension<PowerModelExtension> {
+ public:
+  /**
+   * @brief add add occurrences of an event. Repeated events are merged.
+   * @param eventId id of the event, as obtained from registerEvent
+   * @param n number of occurrences
+   */
+  void add(const unsigned int eventId, const unsigned int n = 1) {
+    for (auto &c : m_events) {
+      if (c.eventId == eventId) {
+        c.n += n;
+        return;
+      }
+    }
+    m_events.push_back({eventId, n});
+  }
+
+  /**
+   * @brief annotate add event occurrences to a transaction's extension, if it
+   * carries one.
+   * @retval true if the transaction carries an extension
+   */
+  static bool annotate(tlm::tlm_generic_payload &trans,
+                       const unsigned int eventId, const unsigned int n = 1) {
+    PowerModelExtension *ext = nullptr;
+    trans.get_extension(ext);
+    if (ext == nullptr) {
+      return false;
+    }
+    ext->add(eventId, n);
+    return true;
+  }
+
+  //! Events accumulated since the last flush
+  const std::vector<PowerModelEventCount> &events() const { return m_events; }
+
+  //! Clear the accumulated events, keeping the allocated storage
+  void clearEvents() { m_events.clear(); }
+
+  //! Reset the extension for reuse with a new transaction
+  void reset(const int initiator = -1) {
+    m_events.clear();
+    energy = 0.0;
+    initiatorId = initiator;
+  }
+
+  virtual tlm::tlm_extension_base *clone() const override {
+    return new PowerModelExtension(*this);
+  }
+
+  virtual void copy_from(const tlm::tlm_extension_base &ext) override {
+    *this = static_cast<const PowerModelExtension &>(ext);
+  }
+
+  //! Energy of all flushed events of this transaction [J]
+  double energy = 0.0;
+
+  //! Id of the issuing initiator, -1 if unknown
+  int initiatorId = -1;
+
+ private:
+  std::vector<PowerModelEventCount> m_events;
+};
+
+/**
+ * @brief PowerModelExtensionSink reports the events accumulated in
+ * PowerModelExtensions to a channel, and keeps per-initiator energy totals.
+ * Call flush() from the terminating target of a transaction, e.g. at the end
+ * of its b_transport.
+ */
+class PowerModelExtensionSink : public sc_core::sc_module {
+ public:
+  sc_core::sc_port<PowerModelChannelOutIf> powerModelPort{"powerModelPort"};
+
+  //! Constructor
+  explicit PowerModelExtensionSink(const sc_core::sc_module_name name)
+      : sc_core::sc_module(name) {}
+
+  /**
+   * @brief flush report a transaction's accumulated events to the channel,
+   * add their energy to the extension and the initiator's total, and clear
+   * them. Does nothing for transactions without extension.
+   * @retval energy of the flushed events in joules
+   */
+  double flush(tlm::tlm_generic_payload &trans) {
+    PowerModelExtension *ext = nullptr;
+    trans.get_extension(ext);
+    if (ext == nullptr || ext->events().empty()) {
+      return 0.0;
+    }
+    double energy = 0.0;
+    for (const auto &c : ext->events()) {
+      energy += c.n * powerModelPort->getEventEnergy(c.eventId);
+    }
+    powerModelPort->reportEvents(ext->events());
+    ext->clearEvents();
+    ext->energy += energy;
+
+    if (ext->initiatorId >= 0) {
+      const unsigned int id = ext->initiatorId;
+      if (id >= m_initiatorEnergy.size()) {
+        m_initiatorEnergy.resize(id + 1, 0.0);
+        m_initiatorTransactions.resize(id + 1, 0);
+      }
+      m_initiatorEnergy[id] += energy;
+      ++m_initiatorTransactions[id];
+    }
+    return energy;
+  }
+
+  //! Energy of all flushed transactions of an initiator [J]
+  double getInitiatorEnergy(const unsigned int initiatorId) const {
+    return initiatorId < m_initiatorEnergy.size()
+               ? m_initiatorEnergy[initiatorId]
+               : 0.0;
+  }
+
+  //! Number of flushed transactions of an initiator
+  uint64_t getInitiatorTransactions(const unsigned int initiatorId) const {
+    return initiatorId < m_initiatorTransactions.size()
+               ? m_initiatorTransactions[initiatorId]
+               : 0;
+  }
+
+ private:
+  std::vector<double> m_initiatorEnergy;
+  std::vector<uint64_t> m_initiatorTransactions;
+};
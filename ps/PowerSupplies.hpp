@@ -7,84 +7,78 @@
 
 #pragma once
 
-#include "utilities/Config.hpp"
 #include <algorithm>
-#include <iostream>
-#include <string>
-// #include <systemc-ams>
-#include <systemc>
+#include <limits>
 
-SCA_TDF_MODULE(ConstantCurrentSupply) {
-  // Consume voltage
-  sca_tdf::sca_in<double> v;
-
-  // Produce contant current
-  sca_tdf::sca_out<double> i;
-
-  void set_attributes() { set_timestep(m_timestep); }
-
-  void initialize(){};
-
-  void processing() {
-    if ((v.read() + m_maxStepSize) < m_voltageLimit) {
-      i.write(m_currentSetpoint);
-    } else {
-      i.write(0.0);
+/**
+ * Supply source characteristic, as seen from a storage capacitor at voltage v:
+ *
+ *   i(v) = min(currentLimit, power / v)    for v < voltageLimit
+ *   i(v) = 0                               otherwise
+ *
+ * Between changes of the load current, this makes the capacitor voltage a
+ * piecewise function with one constant-current piece (v <= power/currentLimit)
+ * and one constant-power piece, both of which have closed-form solutions. See
+ * StorageCapacitor.
+ */
+class SupplySource {
+ public:
+  //! Constructor
+  SupplySource(const double currentLimit_, const double power_,
+               const double voltageLimit_)
+      : currentLimit(currentLimit_), power(power_),
+        voltageLimit(voltageLimit_) {}
+
+  /**
+   * @brief current source current at a given capacitor voltage.
+   * @param v capacitor voltage in volts
+   * @retval source current in amperes
+   */
+  double current(const double v) const {
+    if (v >= voltageLimit) {
+      return 0.0;
+    }
+    if (power <= 0.0) {
+      return 0.0;
     }
+    return v > 0.0 ? std::min(currentLimit, power / v) : currentLimit;
   }
 
-  void ac_processing(){};
-
-  SCA_CTOR(ConstantCurrentSupply) {
-    m_currentSetpoint = Config::get().getDouble("SupplyCurrentLimit");
-    m_voltageLimit = Config::get().getDouble("SupplyVoltageLimit");
-    m_timestep = sc_core::sc_time::from_seconds(
-        Config::get().getDouble("PowerModelTimestep"));
-    m_maxStepSize =
-        m_timestep.to_seconds() *
-        (m_currentSetpoint / Config::get().getDouble("CapacitorValue"));
-  };
-
-private:
-  double m_currentSetpoint;    // [Ampere]
-  double m_voltageLimit;       // [Volt]
-  double m_maxStepSize;        // [Volt] Handy to avoid overshoot
-  sc_core::sc_time m_timestep; // Evaluation timestep
-};
-
-SCA_TDF_MODULE(ConstantPowerSupply) {
-  // Consume voltage
-  sca_tdf::sca_in<double> v;
-
-  // Produce current
-  sca_tdf::sca_out<double> i;
-
-  void set_attributes() { set_timestep(m_timestep); }
-
-  void initialize(){};
-
-  void processing() {
-    auto crntVoltage = v.read();
-    if (crntVoltage < m_voltageLimit) {
-      i.write(std::min(m_currentLimit, m_powerSetpoint / crntVoltage));
-    } else {
-      i.write(0.0);
-    }
+  /**
+   * @brief powerLimitedVoltage voltage above which the source is power limited
+   * rather than current limited.
+   */
+  double powerLimitedVoltage() const {
+    return currentLimit > 0.0 ? power / currentLimit
+                              : std::numeric_limits<double>::infinity();
   }
 
-  void ac_processing(){};
+  /* Public constants */
+  double currentLimit; // [Ampere]
+  double power;        // [Watt]
+  double voltageLimit; // [Volt]
+};
 
-  SCA_CTOR(ConstantPowerSupply) {
-    m_powerSetpoint = Config::get().getDouble("PowerSupplyPower");
-    m_voltageLimit = Config::get().getDouble("SupplyVoltageLimit");
-    m_currentLimit = Config::get().getDouble("SupplyCurrentLimit");
-    m_timestep = sc_core::sc_time::from_seconds(
-        Config::get().getDouble("PowerModelTimestep"));
-  };
+/**
+ * Source that supplies a constant current until the capacitor reaches the
+ * voltage limit.
+ */
+class ConstantCurrentSupply : public SupplySource {
+ public:
+  //! Constructor
+  ConstantCurrentSupply(const double current, const double voltageLimit)
+      : SupplySource(current, std::numeric_limits<double>::infinity(),
+                     voltageLimit) {}
+};
 
-private:
-  double m_powerSetpoint;      // [Watt]
-  double m_currentLimit;       // [Ampere]
-  double m_voltageLimit;       // [Volt]
-  sc_core::sc_time m_timestep; // Evaluation timestep
+/**
+ * Source that supplies a constant power, limited to a maximum current, until
+ * the capacitor reaches the voltage limit.
+ */
+class ConstantPowerSupply : public SupplySource {
+ public:
+  //! Constructor
+  ConstantPowerSupply(const double power, const double currentLimit,
+                      const double voltageLimit)
+      : SupplySource(currentLimit, power, voltageLimit) {}
 };
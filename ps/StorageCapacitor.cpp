@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/StorageCapacitor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+#include <systemc>
+
+using namespace sc_core;
+
+namespace {
+const double inf = std::numeric_limits<double>::infinity();
+} // namespace
+
+StorageCapacitor::StorageCapacitor(const sc_module_name name,
+                                   const double capacitance,
+                                   const double initialVoltage,
+                                   const SupplySource &source)
+    : sc_module(name), m_capacitance(capacitance), m_source(source),
+      m_v(initialVoltage) {
+  if (capacitance <= 0.0) {
+    throw std::invalid_argument(
+        fmt::format("StorageCapacitor::StorageCapacitor capacitance must be "
+                    "positive, got {}",
+                    capacitance));
+  }
+  SC_HAS_PROCESS(StorageCapacitor);
+  SC_METHOD(process);
+  sensitive << i_load << m_wakeupEvent;
+}
+
+int StorageCapacitor::addThreshold(const double voltage) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "StorageCapacitor::addThreshold thresholds can not be added after "
+        "simulation has started.");
+  }
+  m_thresholds.push_back(voltage);
+  m_thresholdEvents.emplace_back(new sc_event());
+  return m_thresholds.size() - 1;
+}
+
+const sc_event &
+StorageCapacitor::thresholdEvent(const unsigned int thresholdId) const {
+  sc_assert(thresholdId < m_thresholdEvents.size());
+  return *m_thresholdEvents[thresholdId];
+}
+
+void StorageCapacitor::setSource(const SupplySource &source) {
+  advance();
+  m_source = source;
+  // Let process() re-select the segment and publish the voltage
+  m_wakeupEvent.cancel();
+  m_nextValid = false;
+  m_wakeupEvent.notify(SC_ZERO_TIME);
+}
+
+double StorageCapacitor::getVoltage() const {
+  const auto now = sc_time_stamp();
+  if (m_nextValid && now >= m_nextTime) {
+    return m_nextVoltage;
+  }
+  return voltageAfter((now - m_t0).to_seconds());
+}
+
+double StorageCapacitor::consume(const sc_time &time,
+                                 const double staticCurrent,
+                                 const double dynamicEnergy) {
+  advance();
+  const double dt = (time - m_lastConsumeTime).to_seconds();
+  m_lastConsumeTime = time;
+  m_loadCurrent =
+      staticCurrent +
+      (dt > 0.0 && m_v > 0.0 ? dynamicEnergy / (m_v * dt) : 0.0);
+  selectMode();
+  schedule();
+  return m_v;
+}
+
+void StorageCapacitor::process() {
+  advance();
+  if (i_load.size() > 0) {
+    m_loadCurrent = i_load->read();
+  }
+  selectMode();
+  if (v_out.size() > 0) {
+    v_out->write(m_v);
+  }
+  schedule();
+}
+
+void StorageCapacitor::advance() {
+  const auto now = sc_time_stamp();
+  if (m_nextValid && now >= m_nextTime) {
+    // Reached the breakpoint, snap to it to avoid accumulating error
+    m_v = m_nextVoltage;
+    m_nextValid = false;
+    for (unsigned int i = 0; i < m_thresholds.size(); ++i) {
+      if (m_thresholds[i] == m_v) {
+        m_thresholdEvents[i]->notify(SC_ZERO_TIME);
+      }
+    }
+  } else if (now > m_t0) {
+    m_v = voltageAfter((now - m_t0).to_seconds());
+  }
+  m_t0 = now;
+}
+
+void StorageCapacitor::selectMode() {
+  const double vlim = m_source.voltageLimit;
+  if (m_v > vlim) {
+    // Source is off; the load discharges the capacitor down to the limit
+    m_mode = Mode::ConstantCurrent;
+  } else if (m_v == vlim && m_source.current(vlim * (1.0 - 1e-12)) >=
+                                m_loadCurrent) {
+    // Source sustains the load at the limit
+    m_mode = Mode::Held;
+  } else if (m_v <= 0.0 && m_source.current(0.0) <= m_loadCurrent) {
+    // Fully discharged and the source can't keep up with the load
+    m_v = 0.0;
+    m_mode = Mode::Held;
+  } else if (m_source.power <= 0.0) {
+    m_mode = Mode::ConstantCurrent;
+  } else {
+    // At the current/power boundary, pick the piece the voltage moves into
+    const double vb = m_source.powerLimitedVoltage();
+    if (m_v < vb || (m_v == vb && m_source.currentLimit <= m_loadCurrent)) {
+      m_mode = Mode::ConstantCurrent;
+    } else {
+      m_mode = Mode::ConstantPower;
+    }
+  }
+}
+
+double StorageCapacitor::netCurrent() const {
+  const bool sourceOn = m_v <= m_source.voltageLimit && m_source.power > 0.0;
+  return (sourceOn ? m_source.currentLimit : 0.0) - m_loadCurrent;
+}
+
+int StorageCapacitor::direction() const {
+  double slope = 0.0;
+  switch (m_mode) {
+  case Mode::ConstantCurrent:
+    slope = netCurrent();
+    break;
+  case Mode::ConstantPower:
+    slope = m_source.power - m_loadCurrent * m_v;
+    break;
+  case Mode::Held:
+    break;
+  }
+  return (slope > 0.0) - (slope < 0.0);
+}
+
+double StorageCapacitor::timeTo(const double target) const {
+  const double dv = target - m_v;
+  if (dv == 0.0) {
+    return 0.0;
+  }
+  switch (m_mode) {
+  case Mode::ConstantCurrent: {
+    const double t = m_capacitance * dv / netCurrent();
+    return t >= 0.0 ? t : inf;
+  }
+  case Mode::ConstantPower: {
+    const double p = m_source.power;
+    const double a = m_loadCurrent;
+    if (a == 0.0) {
+      const double t = m_capacitance * (target * target - m_v * m_v) / (2 * p);
+      return t >= 0.0 ? t : inf;
+    }
+    // Unreachable if the target is at or beyond the equilibrium p/a
+    const double x0 = p - a * m_v;
+    if ((p - a * target) / x0 <= 0.0 || dv * x0 < 0.0) {
+      return inf;
+    }
+    const double z = -a * dv / x0;
+    double y;
+    if (std::abs(z) < 1e-4) {
+      // Series expansion of x0 z - p ln(1 + z), which cancels badly for
+      // small loads
+      y = -a * m_v * z +
+          p * z * z * (0.5 - z * (1.0 / 3.0 - z * (0.25 - z * 0.2)));
+    } else {
+      y = x0 * z - p * std::log1p(z);
+    }
+    return m_capacitance * y / (a * a);
+  }
+  case Mode::Held:
+    break;
+  }
+  return inf;
+}
+
+double StorageCapacitor::voltageAfter(const double dt) const {
+  if (dt <= 0.0) {
+    return m_v;
+  }
+  switch (m_mode) {
+  case Mode::ConstantCurrent:
+    return m_v + netCurrent() * dt / m_capacitance;
+  case Mode::ConstantPower: {
+    const double p = m_source.power;
+    const double a = m_loadCurrent;
+    if (a == 0.0) {
+      return std::sqrt(m_v * m_v + 2 * p * dt / m_capacitance);
+    }
+    // Invert t(v) with a safeguarded Newton iteration, bracketed between
+    // the segment start and the next breakpoint (or the equilibrium)
+    const double bound = m_nextValid ? m_nextVoltage : p / a;
+    double lo = std::min(m_v, bound);
+    double hi = std::max(m_v, bound);
+    const int dir = direction();
+    double v = std::min(hi, std::max(lo, m_v + (p / m_v - a) * dt /
+                                                   m_capacitance));
+    for (int i = 0; i < 100; ++i) {
+      const double f = timeTo(v) - dt;
+      if (f == 0.0) {
+        break;
+      }
+      // t(v) grows in the direction of motion
+      if ((f < 0.0) == (dir > 0)) {
+        lo = v;
+      } else {
+        hi = v;
+      }
+      double next = std::isfinite(f)
+                        ? v - f * (p - a * v) / (m_capacitance * v)
+                        : 0.5 * (lo + hi);
+      if (!(next > lo && next < hi)) {
+        next = 0.5 * (lo + hi);
+      }
+      if (std::abs(next - v) <= 1e-15 * std::abs(v)) {
+        v = next;
+        break;
+      }
+      v = next;
+    }
+    return v;
+  }
+  case Mode::Held:
+    break;
+  }
+  return m_v;
+}
+
+void StorageCapacitor::schedule() {
+  m_wakeupEvent.cancel();
+  m_nextValid = false;
+
+  const int dir = direction();
+  if (dir == 0) {
+    return;
+  }
+
+  // Nearest breakpoint in the direction of motion. The voltage is monotonic
+  // within a segment, so this is also the first one reached.
+  double target = dir * inf;
+  const auto consider = [&](const double v) {
+    if ((v - m_v) * dir > 0.0 && (v - target) * dir < 0.0) {
+      target = v;
+    }
+  };
+  for (const auto v : m_thresholds) {
+    consider(v);
+  }
+  consider(m_source.powerLimitedVoltage());
+  consider(m_source.voltageLimit);
+  consider(0.0);
+
+  const double dt = timeTo(target);
+  if (!std::isfinite(dt)) {
+    return;
+  }
+  m_nextVoltage = target;
+  m_nextTime = m_t0 + sc_time::from_seconds(dt);
+  m_nextValid = true;
+  m_wakeupEvent.notify(m_nextTime - sc_time_stamp());
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "PowerModelConsumerIf.hpp"
+#include "PowerSupplies.hpp"
+
+#include <memory>
+#include <systemc>
+#include <vector>
+
+/**
+ * @brief StorageCapacitor storage capacitor charged by a SupplySource and
+ * discharged by a load current, e.g. the output of a PowerModelBridge.
+ *
+ * The capacitor voltage obeys C dv/dt = i_source(v) - i_load. Instead of
+ * integrating this at a fixed timestep, the module solves it in closed form
+ * between changes of the load current:
+ *  - constant current: v(t) = v0 + (i_source - i_load) t / C
+ *  - constant power:   t(v) = C/a^2 [(P - a v0) z - P ln(1 + z)],
+ *                      z = -a (v - v0) / (P - a v0), a = i_load
+ * The time at which v reaches the next breakpoint (a registered threshold, the
+ * source's current/power-limit boundary or its voltage limit) is computed
+ * directly, and the module wakes up exactly once for it. v_out is only written
+ * at breakpoints and load current changes.
+ *
+ * The load can be driven either through i_load, or by coupling the capacitor
+ * directly to a bridge as its PowerModelConsumerIf, in which case i_load and
+ * v_out may be left unbound.
+ */
+class StorageCapacitor : public sc_core::sc_module,
+                         public PowerModelConsumerIf {
+ public:
+  sc_core::sc_port<sc_core::sc_signal_in_if<double>, 1,
+                   sc_core::SC_ZERO_OR_MORE_BOUND>
+      i_load{"i_load"};
+  sc_core::sc_port<sc_core::sc_signal_inout_if<double>, 1,
+                   sc_core::SC_ZERO_OR_MORE_BOUND>
+      v_out{"v_out"};
+
+  //! Constructor
+  StorageCapacitor(const sc_core::sc_module_name name,
+                   const double capacitance, const double initialVoltage,
+                   const SupplySource &source);
+
+  /**
+   * @brief addThreshold register a voltage threshold. The threshold's event
+   * triggers whenever the capacitor voltage crosses it, in either direction.
+   * Thresholds must be registered before simulation starts.
+   * @param voltage threshold voltage in volts
+   * @retval threshold id
+   */
+  int addThreshold(const double voltage);
+
+  /**
+   * @brief thresholdEvent get the event of a registered threshold.
+   * @param thresholdId id as obtained from addThreshold
+   */
+  const sc_core::sc_event &thresholdEvent(const unsigned int thresholdId) const;
+
+  /**
+   * @brief setSource replace the supply source, e.g. when a harvester's
+   * output changes. Takes effect at the current simulation time.
+   */
+  void setSource(const SupplySource &source);
+
+  /**
+   * @brief getVoltage evaluate the capacitor voltage at the current
+   * simulation time.
+   */
+  double getVoltage() const;
+
+  /**
+   * @brief consume set the load from a bridge's static current and event
+   * energy. The event energy is converted to an average current over the
+   * interval since the previous call. See PowerModelConsumerIf.
+   * @retval capacitor voltage at the current simulation time
+   */
+  virtual double consume(const sc_core::sc_time &time,
+                         const double staticCurrent,
+                         const double dynamicEnergy) override;
+
+ private:
+  //! Operating mode of the source within the current segment
+  enum class Mode {
+    ConstantCurrent, //!< Source delivers its current limit (or nothing)
+    ConstantPower,   //!< Source delivers its power setpoint
+    Held             //!< Voltage clamped at the voltage limit or at 0 V
+  };
+
+  /**
+   * @brief process SC_METHOD, triggered by load current changes and
+   * breakpoint wakeups.
+   */
+  void process();
+
+  /**
+   * @brief advance move the segment start to the current simulation time.
+   */
+  void advance();
+
+  //! Select the segment mode for the present voltage and load
+  void selectMode();
+
+  //! Net current into the capacitor in a constant-current segment
+  double netCurrent() const;
+
+  /**
+   * @brief timeTo time (in seconds from the segment start) at which the
+   * voltage reaches a target, or infinity if it never does in this segment.
+   */
+  double timeTo(const double target) const;
+
+  /**
+   * @brief voltageAfter voltage after dt seconds in this segment. dt must not
+   * exceed the time of the next breakpoint.
+   * @param dt time since the segment start in seconds
+   */
+  double voltageAfter(const double dt) const;
+
+  //! Direction of the voltage change in this segment (-1, 0 or 1)
+  int direction() const;
+
+  //! Schedule the wakeup for the next breakpoint
+  void schedule();
+
+  const double m_capacitance; // [Farad]
+  SupplySource m_source;
+  double m_loadCurrent = 0.0; // [Ampere]
+
+  //! Time of the last call to consume
+  sc_core::sc_time m_lastConsumeTime{sc_core::SC_ZERO_TIME};
+
+  //! Segment start
+  double m_v;
+  sc_core::sc_time m_t0{sc_core::SC_ZERO_TIME};
+  Mode m_mode = Mode::ConstantCurrent;
+
+  //! Next breakpoint
+  sc_core::sc_time m_nextTime{sc_core::SC_ZERO_TIME};
+  double m_nextVoltage = 0.0;
+  bool m_nextValid = false;
+
+  std::vector<double> m_thresholds;
+  std::vector<std::unique_ptr<sc_core::sc_event>> m_thresholdEvents;
+
+  sc_core::sc_event m_wakeupEvent{"wakeupEvent"};
+};
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/SweepRunner.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <poll.h>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <yaml-cpp/yaml.h>
+#include "ps/PowerModelDatabase.hpp"
+
+namespace {
+//! Values of one sweep parameter
+std::vector<double> parameterValues(const std::string &key,
+                                    const YAML::Node &node) {
+  std::vector<double> values;
+  if (node.IsSequence()) {
+    for (const auto &v : node) {
+      values.push_back(v.as<double>());
+    }
+  } else if (node.IsMap()) {
+    // Linear range
+    const double from = node["from"].as<double>();
+    const double to = node["to"].as<double>();
+    const unsigned int steps = node["steps"].as<unsigned int>();
+    for (unsigned int i = 0; i < steps; ++i) {
+      values.push_back(steps > 1 ? from + (to - from) * i / (steps - 1)
+                                 : from);
+    }
+  } else {
+    values.push_back(node.as<double>());
+  }
+  if (values.empty()) {
+    throw std::invalid_argument(fmt::format(
+        "SweepRunner::SweepRunner parameter '{:s}' has no values", key));
+  }
+  return values;
+}
+
+//! Write a buffer to a file descriptor, retrying on partial writes
+bool writeAll(const int fd, const std::string &data) {
+  size_t done = 0;
+  while (done < data.size()) {
+    const ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+} // namespace
+
+SweepRunner::SweepRunner(const std::string &specPath) {
+  YAML::Node spec;
+  try {
+    spec = YAML::LoadFile(specPath);
+  } catch (const YAML::Exception &e) {
+    throw std::runtime_error(fmt::format(
+        "SweepRunner::SweepRunner can't load {:s}: {:s}", specPath, e.what()));
+  }
+
+  // sysconf returns -1 if the core count is unknown. More workers than cores
+  // only time-slice the runs
+  const unsigned int cores = std::max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+  setWorkers(spec["workers"]
+                 ? std::min(spec["workers"].as<unsigned int>(), cores)
+                 : cores);
+
+  // Loaded (and mapped) once here, shared with the workers after fork
+  if (const auto db = spec["database"]) {
+    if (db.IsSequence()) {
+      for (const auto &f : db) {
+        PowerModelDatabase::get().load(f.as<std::string>());
+      }
+    } else {
+      PowerModelDatabase::get().load(db.as<std::string>());
+    }
+  }
+  const std::string output =
+      spec["output"] ? spec["output"].as<std::string>() : "sweep";
+
+  std::vector<std::pair<std::string, std::vector<double>>> axes;
+  for (const auto &p : spec["parameters"]) {
+    const auto key = p.first.as<std::string>();
+    axes.emplace_back(key, parameterValues(key, p.second));
+  }
+
+  // Cartesian product, the last parameter varies fastest
+  size_t n = 1;
+  for (const auto &a : axes) {
+    n *= a.second.size();
+  }
+  for (size_t i = 0; i < n; ++i) {
+    Point p{static_cast<unsigned int>(i), Values(axes.size()),
+            fmt::format("{:s}/run{:d}", output, i)};
+    size_t rest = i;
+    for (size_t a = axes.size(); a-- > 0;) {
+      const auto &values = axes[a].second;
+      p.parameters[a] = {axes[a].first, values[rest % values.size()]};
+      rest /= values.size();
+    }
+    m_points.push_back(std::move(p));
+  }
+}
+
+unsigned int SweepRunner::run(const RunFunction &fn,
+                              const std::string &resultPath) {
+  struct Worker {
+    pid_t pid;
+    int fd;
+    unsigned int point;
+    std::string data;
+  };
+
+  const unsigned int n = m_points.size();
+  std::vector<Values> results(n);
+  std::vector<bool> ok(n, false);
+  std::vector<Worker> live;
+  std::vector<pollfd> fds;
+  unsigned int next = 0;
+  unsigned int failed = 0;
+
+  spdlog::info("SweepRunner: {:d} runs on {:d} workers", n, m_workers);
+  while (next < n || !live.empty()) {
+    while (live.size() < m_workers && next < n) {
+      int p[2];
+      if (pipe(p) != 0) {
+        throw std::runtime_error(fmt::format("SweepRunner::run pipe: {:s}",
+                                             std::strerror(errno)));
+      }
+      // Don't duplicate buffered output into the child
+      std::fflush(nullptr);
+      const pid_t pid = fork();
+      if (pid < 0) {
+        throw std::runtime_error(fmt::format("SweepRunner::run fork: {:s}",
+                                             std::strerror(errno)));
+      }
+      if (pid == 0) {
+        ::close(p[0]);
+        for (const auto &w : live) {
+          ::close(w.fd);
+        }
+        runWorker(fn, m_points[next], p[1]);
+      }
+      ::close(p[1]);
+      live.push_back({pid, p[0], next, {}});
+      ++next;
+    }
+
+    fds.clear();
+    for (const auto &w : live) {
+      fds.push_back({w.fd, POLLIN, 0});
+    }
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(
+          fmt::format("SweepRunner::run poll: {:s}", std::strerror(errno)));
+    }
+
+    // Backwards, so erasing keeps fds and live aligned
+    for (size_t i = live.size(); i-- > 0;) {
+      if ((fds[i].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+        continue;
+      }
+      auto &w = live[i];
+      char buf[4096];
+      const ssize_t r = ::read(w.fd, buf, sizeof(buf));
+      if (r > 0) {
+        w.data.append(buf, r);
+        continue;
+      }
+      if (r < 0 && errno == EINTR) {
+        continue;
+      }
+      // End of output, the worker is done
+      ::close(w.fd);
+      int status = 0;
+      waitpid(w.pid, &status, 0);
+      ok[w.point] = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                    parseResults(w.data, results[w.point]);
+      if (ok[w.point]) {
+        spdlog::info("SweepRunner: run {:d} done", w.point);
+      } else {
+        spdlog::warn("SweepRunner: run {:d} failed", w.point);
+        failed++;
+      }
+      live.erase(live.begin() + i);
+    }
+  }
+
+  writeResults(resultPath, results, ok);
+  return failed;
+}
+
+void SweepRunner::runWorker(const RunFunction &fn, const Point &point,
+                            const int fd) {
+  int status = 0;
+  try {
+    auto &db = PowerModelDatabase::get();
+    for (const auto &p : point.parameters) {
+      db.set(p.first, p.second);
+    }
+    std::string out;
+    for (const auto &r : fn(point)) {
+      if (r.first.find_first_of("\t\n") != std::string::npos) {
+        throw std::invalid_argument(fmt::format(
+            "SweepRunner::run result name '{:s}' contains a tab or newline",
+            r.first));
+      }
+      out += fmt::format("{:s}\t{:.17g}\n", r.first, r.second);
+    }
+    if (!writeAll(fd, out)) {
+      status = 1;
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("SweepRunner: run {:d}: {:s}", point.index, e.what());
+    status = 1;
+  }
+  ::close(fd);
+  std::fflush(nullptr);
+  // Skip the parent's static destructors, e.g. its database mappings
+  _exit(status);
+}
+
+bool SweepRunner::parseResults(const std::string &data, Values &results) {
+  size_t pos = 0;
+  while (pos < data.size()) {
+    const size_t eol = data.find('\n', pos);
+    const size_t tab = data.find('\t', pos);
+    if (eol == std::string::npos || tab == std::string::npos || tab > eol) {
+      return false;
+    }
+    const std::string value = data.substr(tab + 1, eol - tab - 1);
+    char *end = nullptr;
+    const double v = std::strtod(value.c_str(), &end);
+    if (end == value.c_str()) {
+      return false;
+    }
+    results.emplace_back(data.substr(pos, tab - pos), v);
+    pos = eol + 1;
+  }
+  return true;
+}
+
+void SweepRunner::writeResults(const std::string &resultPath,
+                               const std::vector<Values> &results,
+                               const std::vector<bool> &ok) const {
+  std::ofstream f(resultPath, std::ios::out | std::ios::trunc);
+  if (!f.good()) {
+    throw std::runtime_error(fmt::format(
+        "SweepRunner::run can't open result file {:s}", resultPath));
+  }
+
+  // Result columns in order of first appearance
+  std::vector<std::string> columns;
+  for (const auto &r : results) {
+    for (const auto &v : r) {
+      if (std::find(columns.begin(), columns.end(), v.first) ==
+          columns.end()) {
+        columns.push_back(v.first);
+      }
+    }
+  }
+
+  f << "run";
+  if (!m_points.empty()) {
+    for (const auto &p : m_points[0].parameters) {
+      f << ',' << p.first;
+    }
+  }
+  f << ",status";
+  for (const auto &c : columns) {
+    f << ',' << c;
+  }
+  f << '\n';
+
+  for (unsigned int i = 0; i < m_points.size(); ++i) {
+    f << i;
+    for (const auto &p : m_points[i].parameters) {
+      f << fmt::format(",{:.10g}", p.second);
+    }
+    f << (ok[i] ? ",ok" : ",failed");
+    for (const auto &c : columns) {
+      const auto it = std::find_if(
+          results[i].begin(), results[i].end(),
+          [&c](const std::pair<std::string, double> &v) {
+            return v.first == c;
+          });
+      f << ',';
+      if (it != results[i].end()) {
+        f << fmt::format("{:.10g}", it->second);
+      }
+    }
+    f << '\n';
+  }
+  spdlog::info("SweepRunner: results written to {:s}", resultPath);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief SweepRunner runs a parameter sweep with one worker process per run.
+ *
+ * SystemC can only elaborate and run one simulation per process, so each
+ * point of the sweep is run in a forked child. The sweep is described in a
+ * YAML file:
+ *
+ *   database: model.yaml          # optional, file or list of files
+ *   workers: 16                   # optional, at most the core count
+ *   output: sweep                 # optional, per-run output directories
+ *   parameters:                   # cartesian product of all values
+ *     "memory read": [1.0e-11, 2.0e-11, 5.0e-11]
+ *     "memory on": {from: 1.0e-4, to: 5.0e-4, steps: 5}
+ *
+ * The parent loads the database files before forking, so the workers share
+ * its memory-mapped tables. Each worker sets the parameters of its point as
+ * PowerModelDatabase overrides, calls the run function, which builds and
+ * simulates the model and returns named results (e.g. channel energies),
+ * and streams them back to the parent over a pipe. The parent collects all
+ * runs into one csv table.
+ *
+ * run() must be called from sc_main before any SystemC object is created.
+ */
+class SweepRunner {
+ public:
+  //! Named values, e.g. parameters or results
+  typedef std::vector<std::pair<std::string, double>> Values;
+
+  //! Point of the sweep
+  struct Point {
+    unsigned int index;
+    Values parameters;
+    //! Directory for the run's logs, e.g. for PowerModelChannel
+    std::string outputDir;
+  };
+
+  //! Function run by a worker for one point, returns the run's results
+  typedef std::function<Values(const Point &)> RunFunction;
+
+  //! Constructor, parses the sweep spec and loads its database files
+  explicit SweepRunner(const std::string &specPath);
+
+  //! Points of the sweep, in run order
+  const std::vector<Point> &points() const { return m_points; }
+
+  //! Number of concurrent workers
+  unsigned int workers() const { return m_workers; }
+  void setWorkers(const unsigned int n) { m_workers = n > 0 ? n : 1; }
+
+  /**
+   * @brief run run all points, at most workers() at a time, and write the
+   * result table.
+   * @param fn function run for each point, in a worker process
+   * @param resultPath path of the csv result table, one row per point with
+   * its parameters, status and results
+   * @retval number of failed runs
+   */
+  unsigned int run(const RunFunction &fn, const std::string &resultPath);
+
+ private:
+  //! Run one point in the calling (child) process, write results to fd
+  static void runWorker(const RunFunction &fn, const Point &point,
+                        const int fd);
+
+  //! Parse a worker's output into results. Returns false if malformed.
+  static bool parseResults(const std::string &data, Values &results);
+
+  //! Write the result table
+  void writeResults(const std::string &resultPath,
+                    const std::vector<Values> &results,
+                    const std::vector<bool> &ok) const;
+
+  std::vector<Point> m_points;
+  unsigned int m_workers;
+};
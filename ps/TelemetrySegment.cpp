@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/TelemetrySegment.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <spdlog/fmt/fmt.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+const char telemetryMagic[8] = {'F', 'U', 'S', 'E', 'D', 'T', 'L', 'M'};
+
+//! Size of a segment with n modules
+size_t segmentSize(const uint32_t n, const uint32_t nameLength) {
+  return sizeof(TelemetryHeader) + n * nameLength + n * sizeof(double);
+}
+} // namespace
+
+const uint32_t TelemetryWriter::formatVersion;
+const uint32_t TelemetryWriter::nameLength;
+
+TelemetryWriter::TelemetryWriter(const std::string &segmentName,
+                                 const std::vector<std::string> &moduleNames)
+    : m_segmentName("/" + segmentName) {
+  static_assert(sizeof(TelemetryHeader) % sizeof(double) == 0 &&
+                    nameLength % sizeof(double) == 0,
+                "TelemetryWriter: module power must stay aligned");
+  const uint32_t n = moduleNames.size();
+  m_size = segmentSize(n, nameLength);
+
+  const int fd =
+      shm_open(m_segmentName.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error(
+        fmt::format("TelemetryWriter::TelemetryWriter can't create {:s}: {:s}",
+                    m_segmentName, std::strerror(errno)));
+  }
+  if (ftruncate(fd, m_size) != 0) {
+    ::close(fd);
+    shm_unlink(m_segmentName.c_str());
+    throw std::runtime_error(
+        fmt::format("TelemetryWriter::TelemetryWriter can't size {:s}: {:s}",
+                    m_segmentName, std::strerror(errno)));
+  }
+  m_map = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (m_map == MAP_FAILED) {
+    m_map = nullptr;
+    shm_unlink(m_segmentName.c_str());
+    throw std::runtime_error(
+        fmt::format("TelemetryWriter::TelemetryWriter can't map {:s}: {:s}",
+                    m_segmentName, std::strerror(errno)));
+  }
+
+  // The segment is zero-filled, so the sequence starts at 0
+  m_header = new (m_map) TelemetryHeader();
+  m_header->version = formatVersion;
+  m_header->nModules = n;
+  m_header->nameLength = nameLength;
+  auto names = static_cast<char *>(m_map) + sizeof(TelemetryHeader);
+  for (uint32_t i = 0; i < n; ++i) {
+    const size_t len = std::min<size_t>(moduleNames[i].size(), nameLength - 1);
+    std::memcpy(names + i * nameLength, moduleNames[i].data(), len);
+  }
+  m_modulePower = reinterpret_cast<double *>(names + n * nameLength);
+  // Magic last, readers reject the segment until it is initialized
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(m_header->magic, telemetryMagic, sizeof(telemetryMagic));
+}
+
+TelemetryWriter::~TelemetryWriter() {
+  if (m_map != nullptr) {
+    munmap(m_map, m_size);
+    shm_unlink(m_segmentName.c_str());
+  }
+}
+
+void TelemetryWriter::publish(const TelemetrySnapshot &s) {
+  const uint64_t seq = m_header->sequence.load(std::memory_order_relaxed);
+  m_header->sequence.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  m_header->time = s.time;
+  m_header->supplyVoltage = s.supplyVoltage;
+  m_header->staticPower = s.staticPower;
+  m_header->dynamicPower = s.dynamicPower;
+  m_header->totalEnergy = s.totalEnergy;
+  std::copy(s.modulePower.begin(),
+            s.modulePower.begin() + m_header->nModules, m_modulePower);
+
+  m_header->sequence.store(seq + 2, std::memory_order_release);
+}
+
+TelemetryReader::TelemetryReader(const std::string &segmentName) {
+  const std::string path = "/" + segmentName;
+  const int fd = shm_open(path.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw std::runtime_error(fmt::format(
+        "TelemetryReader::TelemetryReader can't open {:s}: {:s}", path,
+        std::strerror(errno)));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(TelemetryHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format(
+        "TelemetryReader::TelemetryReader {:s} is too small", path));
+  }
+  m_size = st.st_size;
+  void *map = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    throw std::runtime_error(fmt::format(
+        "TelemetryReader::TelemetryReader can't map {:s}: {:s}", path,
+        std::strerror(errno)));
+  }
+  m_map = map;
+  m_header = static_cast<const TelemetryHeader *>(m_map);
+
+  const bool valid =
+      std::memcmp(m_header->magic, telemetryMagic, sizeof(telemetryMagic)) ==
+          0 &&
+      m_header->version == TelemetryWriter::formatVersion &&
+      m_size == segmentSize(m_header->nModules, m_header->nameLength);
+  if (!valid) {
+    munmap(map, m_size);
+    m_map = nullptr;
+    throw std::runtime_error(fmt::format(
+        "TelemetryReader::TelemetryReader {:s} is not a telemetry segment of "
+        "version {:d}",
+        path, TelemetryWriter::formatVersion));
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  const auto names = static_cast<const char *>(m_map) + sizeof(TelemetryHeader);
+  for (uint32_t i = 0; i < m_header->nModules; ++i) {
+    const char *name = names + i * m_header->nameLength;
+    m_names.emplace_back(name, strnlen(name, m_header->nameLength));
+  }
+  m_modulePower = reinterpret_cast<const double *>(
+      names + m_header->nModules * m_header->nameLength);
+}
+
+TelemetryReader::~TelemetryReader() {
+  if (m_map != nullptr) {
+    munmap(const_cast<void *>(m_map), m_size);
+  }
+}
+
+bool TelemetryReader::read(TelemetrySnapshot &s,
+                           const unsigned int maxAttempts) const {
+  const uint32_t n = m_header->nModules;
+  s.modulePower.resize(n);
+  for (unsigned int attempt = 0; attempt < maxAttempts; ++attempt) {
+    const uint64_t seq = m_header->sequence.load(std::memory_order_acquire);
+    if (seq & 1) {
+      // Writer is updating
+      continue;
+    }
+    s.time = m_header->time;
+    s.supplyVoltage = m_header->supplyVoltage;
+    s.staticPower = m_header->staticPower;
+    s.dynamicPower = m_header->dynamicPower;
+    s.totalEnergy = m_header->totalEnergy;
+    std::copy(m_modulePower, m_modulePower + n, s.modulePower.begin());
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (m_header->sequence.load(std::memory_order_relaxed) == seq) {
+      s.sequence = seq;
+      return true;
+    }
+  }
+  return false;
+}
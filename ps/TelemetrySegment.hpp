@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Live telemetry in a POSIX shared-memory segment
+ * ------------------------------------------------
+ *
+ * A PowerModelChannel with telemetry enabled publishes a snapshot of its
+ * power consumption to a shared-memory segment ("/<name>") at a fixed rate.
+ * External monitors map the segment and read snapshots without system calls
+ * and without synchronizing with the simulation.
+ *
+ * The segment is a TelemetryHeader, followed by nModules module names of
+ * nameLength bytes each (nul-terminated), and nModules doubles of module
+ * power. Snapshots are protected by a sequence lock: the writer makes
+ * `sequence` odd while it updates the snapshot, and readers retry until they
+ * have copied a snapshot under the same even sequence number.
+ */
+
+//! Fixed part of the telemetry segment
+struct TelemetryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t nModules;
+  uint32_t nameLength;
+  uint32_t reserved;
+  std::atomic<uint64_t> sequence;
+  double time;          // [s]
+  double supplyVoltage; // [V]
+  double staticPower;   // [W]
+  double dynamicPower;  // [W]
+  double totalEnergy;   // [J]
+};
+
+//! Snapshot of the telemetry, as copied by a reader
+struct TelemetrySnapshot {
+  uint64_t sequence = 0;
+  double time = 0.0;
+  double supplyVoltage = 0.0;
+  double staticPower = 0.0;
+  double dynamicPower = 0.0;
+  double totalEnergy = 0.0;
+  std::vector<double> modulePower;
+};
+
+/**
+ * @brief TelemetryWriter creates a telemetry segment and publishes snapshots
+ * to it. The segment is removed again when the writer is destroyed.
+ */
+class TelemetryWriter {
+ public:
+  //! Segment format version. Bump when the layout changes.
+  static const uint32_t formatVersion = 1;
+
+  //! Length of a module name in the segment, including the terminating nul
+  static const uint32_t nameLength = 48;
+
+  /**
+   * @brief Constructor, creates (or replaces) the segment.
+   * @param segmentName name of the segment, without the leading '/'
+   * @param moduleNames names of the modules, truncated to fit
+   */
+  TelemetryWriter(const std::string &segmentName,
+                  const std::vector<std::string> &moduleNames);
+
+  //! Destructor, unmaps and removes the segment
+  ~TelemetryWriter();
+
+  TelemetryWriter(const TelemetryWriter &) = delete;
+  TelemetryWriter &operator=(const TelemetryWriter &) = delete;
+
+  /**
+   * @brief publish write a snapshot. The sequence number is ignored.
+   * @param s snapshot, s.modulePower must have one entry per module
+   */
+  void publish(const TelemetrySnapshot &s);
+
+ private:
+  std::string m_segmentName;
+  void *m_map = nullptr;
+  size_t m_size = 0;
+  TelemetryHeader *m_header = nullptr;
+  double *m_modulePower = nullptr;
+};
+
+/**
+ * @brief TelemetryReader maps an existing telemetry segment read-only.
+ */
+class TelemetryReader {
+ public:
+  /**
+   * @brief Constructor, maps the segment. Throws std::runtime_error if it
+   * does not exist or has an unknown format.
+   * @param segmentName name of the segment, without the leading '/'
+   */
+  explicit TelemetryReader(const std::string &segmentName);
+
+  //! Destructor, unmaps the segment
+  ~TelemetryReader();
+
+  TelemetryReader(const TelemetryReader &) = delete;
+  TelemetryReader &operator=(const TelemetryReader &) = delete;
+
+  //! Module names, in the order of TelemetrySnapshot::modulePower
+  const std::vector<std::string> &moduleNames() const { return m_names; }
+
+  /**
+   * @brief read copy a consistent snapshot.
+   * @param s snapshot to fill in
+   * @param maxAttempts number of attempts while the writer is updating
+   * @retval false if no consistent snapshot could be copied
+   */
+  bool read(TelemetrySnapshot &s, const unsigned int maxAttempts = 1000) const;
+
+ private:
+  const void *m_map = nullptr;
+  size_t m_size = 0;
+  const TelemetryHeader *m_header = nullptr;
+  const double *m_modulePower = nullptr;
+  std::vector<std::string> m_names;
+};
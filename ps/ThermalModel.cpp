@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/ThermalModel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+using namespace sc_core;
+
+namespace {
+//! c = a * b, for n x n row-major matrices
+void matmul(const std::vector<double> &a, const std::vector<double> &b,
+            std::vector<double> &c, const unsigned int n) {
+  std::fill(c.begin(), c.end(), 0.0);
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int k = 0; k < n; ++k) {
+      const double aik = a[i * n + k];
+      for (unsigned int j = 0; j < n; ++j) {
+        c[i * n + j] += aik * b[k * n + j];
+      }
+    }
+  }
+}
+
+//! Matrix exponential by scaling & squaring of a truncated Taylor series
+std::vector<double> expm(std::vector<double> m, const unsigned int n) {
+  double norm = 0.0;
+  for (unsigned int i = 0; i < n; ++i) {
+    double row = 0.0;
+    for (unsigned int j = 0; j < n; ++j) {
+      row += std::fabs(m[i * n + j]);
+    }
+    norm = std::max(norm, row);
+  }
+  int squarings = 0;
+  if (norm > 0.5) {
+    squarings = static_cast<int>(std::ceil(std::log2(norm / 0.5)));
+  }
+  const double scale = std::ldexp(1.0, -squarings);
+  for (auto &x : m) {
+    x *= scale;
+  }
+
+  // exp(m) ~ sum_k m^k / k!, converges to machine precision for |m| <= 0.5
+  std::vector<double> result(n * n, 0.0), term(n * n, 0.0), tmp(n * n);
+  for (unsigned int i = 0; i < n; ++i) {
+    result[i * n + i] = term[i * n + i] = 1.0;
+  }
+  for (int k = 1; k <= 20; ++k) {
+    matmul(term, m, tmp, n);
+    for (unsigned int i = 0; i < n * n; ++i) {
+      term[i] = tmp[i] / k;
+      result[i] += term[i];
+    }
+  }
+
+  for (int s = 0; s < squarings; ++s) {
+    matmul(result, result, tmp, n);
+    result.swap(tmp);
+  }
+  return result;
+}
+} // namespace
+
+ThermalModel::ThermalModel(const sc_module_name name, const sc_time timestep,
+                           const double ambientTemperature)
+    : sc_module(name), m_timestep(timestep),
+      m_ambientTemperature(ambientTemperature) {
+  SC_HAS_PROCESS(ThermalModel);
+  SC_METHOD(process);
+}
+
+unsigned int ThermalModel::addNode(const double capacitance,
+                                   const double ambientConductance) {
+  if (sc_is_running()) {
+    throw std::runtime_error(
+        "ThermalModel::addNode nodes can only be added during elaboration.");
+  }
+  if (!(capacitance > 0.0) || ambientConductance < 0.0) {
+    throw std::invalid_argument(fmt::format(
+        FMT_STRING("ThermalModel::addNode invalid capacitance={:g} or "
+                   "ambientConductance={:g}"),
+        capacitance, ambientConductance));
+  }
+
+  // Grow the conductance matrix by one row & column
+  const unsigned int n = m_n + 1;
+  std::vector<double> g(n * n, 0.0);
+  for (unsigned int i = 0; i < m_n; ++i) {
+    std::copy_n(&m_conductance[i * m_n], m_n, &g[i * n]);
+  }
+  g[m_n * n + m_n] = ambientConductance;
+  m_conductance.swap(g);
+  m_capacitance.push_back(capacitance);
+  m_n = n;
+  return n - 1;
+}
+
+void ThermalModel::addConductance(const unsigned int a, const unsigned int b,
+                                  const double conductance) {
+  sc_assert(a < m_n && b < m_n && a != b);
+  m_conductance[a * m_n + a] += conductance;
+  m_conductance[b * m_n + b] += conductance;
+  m_conductance[a * m_n + b] -= conductance;
+  m_conductance[b * m_n + a] -= conductance;
+}
+
+void ThermalModel::addModule(const unsigned int node,
+                             const std::string &moduleName) {
+  sc_assert(node < m_n);
+  m_modules.push_back({node, moduleName, -1, 0.0});
+}
+
+void ThermalModel::addLeakageState(const unsigned int node,
+                                   const std::string &moduleName,
+                                   std::shared_ptr<LeakageCurrentState> state) {
+  sc_assert(node < m_n);
+  state->setTemperature(m_ambientTemperature);
+  m_leakageStates.push_back({node, moduleName, -1, std::move(state)});
+}
+
+double ThermalModel::getTemperature(const unsigned int node) const {
+  sc_assert(node < m_n);
+  return m_ambientTemperature +
+         (m_temperature.empty() ? 0.0 : m_temperature[node]);
+}
+
+void ThermalModel::start_of_simulation() {
+  for (auto &m : m_modules) {
+    m.moduleId = powerModelPort->getModuleId(m.name);
+    if (m.moduleId < 0) {
+      SC_REPORT_FATAL(this->name(),
+                      fmt::format("Module '{}' is not registered with the "
+                                  "power model channel",
+                                  m.name)
+                          .c_str());
+    }
+  }
+  for (auto &l : m_leakageStates) {
+    l.moduleId = powerModelPort->getModuleId(l.name);
+    if (l.moduleId < 0) {
+      SC_REPORT_FATAL(this->name(),
+                      fmt::format("Module '{}' is not registered with the "
+                                  "power model channel",
+                                  l.name)
+                          .c_str());
+    }
+  }
+  m_temperature.assign(m_n, 0.0);
+  m_next.resize(m_n);
+  m_power.resize(m_n);
+  discretize();
+}
+
+void ThermalModel::discretize() {
+  // Augmented system [[A h, C^-1 h], [0, 0]], whose exponential is
+  // [[Phi, Gamma], [0, I]]
+  const unsigned int n = m_n;
+  const unsigned int n2 = 2 * n;
+  const double h = m_timestep.to_seconds();
+  std::vector<double> m(n2 * n2, 0.0);
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int j = 0; j < n; ++j) {
+      m[i * n2 + j] = -m_conductance[i * n + j] / m_capacitance[i] * h;
+    }
+    m[i * n2 + n + i] = h / m_capacitance[i];
+  }
+  const auto e = expm(std::move(m), n2);
+
+  m_phi.resize(n * n);
+  m_gamma.resize(n * n);
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int j = 0; j < n; ++j) {
+      m_phi[i * n + j] = e[i * n2 + j];
+      m_gamma[i * n + j] = e[i * n2 + n + j];
+    }
+  }
+}
+
+void ThermalModel::process() {
+  // Initialization run
+  if (!m_started) {
+    m_started = true;
+    next_trigger(m_timestep);
+    return;
+  }
+
+  // Node power from the modules' energy over the last step
+  const double h = m_timestep.to_seconds();
+  std::fill(m_power.begin(), m_power.end(), 0.0);
+  for (auto &m : m_modules) {
+    const double e = powerModelPort->getModuleEnergy(m.moduleId);
+    m_power[m.node] += (e - m.lastEnergy) / h;
+    m.lastEnergy = e;
+  }
+
+  const unsigned int n = m_n;
+  for (unsigned int i = 0; i < n; ++i) {
+    double t = 0.0;
+    for (unsigned int j = 0; j < n; ++j) {
+      t += m_phi[i * n + j] * m_temperature[j] + m_gamma[i * n + j] * m_power[j];
+    }
+    m_next[i] = t;
+  }
+  m_temperature.swap(m_next);
+
+  for (const auto &l : m_leakageStates) {
+    const double before = l.state->getTemperature();
+    l.state->setTemperature(m_ambientTemperature + m_temperature[l.node]);
+    if (l.state->getTemperature() != before) {
+      // Integrate at the old current, and pick up the new one
+      powerModelPort->refreshStateCurrents(l.moduleId);
+    }
+  }
+
+  next_trigger(m_timestep);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "LeakageCurrentState.hpp"
+#include "PowerModelChannelIf.hpp"
+
+#include <memory>
+#include <string>
+#include <systemc>
+#include <vector>
+
+/**
+ * @brief ThermalModel compact RC thermal network driven by the module power
+ * of a PowerModelChannel.
+ *
+ * Each node has a heat capacity and a conductance to ambient, and nodes may
+ * be coupled by conductances. Channel modules are mapped to nodes, and every
+ * timestep the energy each module consumed during the step heats its node.
+ * With the power held constant over a step of length h, the node temperatures
+ * (relative to ambient) advance exactly as
+ *
+ *   T[k+1] = Phi T[k] + Gamma P[k],   Phi = exp(A h),
+ *   Gamma = A^-1 (Phi - I) C^-1,      A = -C^-1 G
+ *
+ * Phi and Gamma are computed once at the start of simulation, so each step
+ * costs two small matrix-vector products. After each step, the temperature
+ * of each node is fed back into the LeakageCurrentStates attached to it, and
+ * the channel re-evaluates the currents of their modules.
+ */
+class ThermalModel : public sc_core::sc_module {
+ public:
+  sc_core::sc_port<PowerModelChannelOutIf> powerModelPort{"powerModelPort"};
+
+  /**
+   * @brief Constructor
+   * @param name module name
+   * @param timestep thermal solver step
+   * @param ambientTemperature ambient temperature [deg C]
+   */
+  ThermalModel(const sc_core::sc_module_name name,
+               const sc_core::sc_time timestep,
+               const double ambientTemperature = 25.0);
+
+  /**
+   * @brief addNode add a thermal node. Must be called during elaboration.
+   * @param capacitance heat capacity [J/K]
+   * @param ambientConductance thermal conductance to ambient [W/K]
+   * @retval node id
+   */
+  unsigned int addNode(const double capacitance,
+                       const double ambientConductance);
+
+  /**
+   * @brief addConductance couple two nodes.
+   * @param a, b node ids
+   * @param conductance thermal conductance [W/K]
+   */
+  void addConductance(const unsigned int a, const unsigned int b,
+                      const double conductance);
+
+  /**
+   * @brief addModule map a channel module to a node. The module's power
+   * heats the node.
+   * @param node node id
+   * @param moduleName module name as registered with the channel
+   */
+  void addModule(const unsigned int node, const std::string &moduleName);
+
+  /**
+   * @brief addLeakageState attach a leakage state to a node. The state's
+   * temperature follows the node's.
+   * @param node node id
+   * @param moduleName name of the module the state is registered with
+   * @param state the leakage state
+   */
+  void addLeakageState(const unsigned int node, const std::string &moduleName,
+                       std::shared_ptr<LeakageCurrentState> state);
+
+  //! Temperature of a node [deg C]
+  double getTemperature(const unsigned int node) const;
+
+  virtual void start_of_simulation() override;
+
+  const sc_core::sc_time m_timestep;
+  const double m_ambientTemperature;
+
+ private:
+  //! SC_METHOD, advances the network by one timestep
+  void process();
+
+  //! Compute m_phi and m_gamma from the node parameters
+  void discretize();
+
+  unsigned int m_n = 0;
+  std::vector<double> m_capacitance;
+  //! Conductance matrix, row-major, built up during elaboration
+  std::vector<double> m_conductance;
+
+  //! Propagators, row-major m_n x m_n
+  std::vector<double> m_phi;
+  std::vector<double> m_gamma;
+
+  //! Node temperatures relative to ambient, and a scratch vector
+  std::vector<double> m_temperature;
+  std::vector<double> m_next;
+
+  //! Node power in the last step
+  std::vector<double> m_power;
+
+  struct ModuleEntry {
+    unsigned int node;
+    std::string name;
+    int moduleId;
+    double lastEnergy;
+  };
+  std::vector<ModuleEntry> m_modules;
+
+  struct LeakageEntry {
+    unsigned int node;
+    std::string name;
+    int moduleId;
+    std::shared_ptr<LeakageCurrentState> state;
+  };
+  std::vector<LeakageEntry> m_leakageStates;
+
+  bool m_started = false;
+};
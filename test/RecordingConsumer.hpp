@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <systemc>
+#include "ps/PowerModelConsumerIf.hpp"
+
+//! Test consumer that records its arguments and returns a fixed voltage
+struct RecordingConsumer : public PowerModelConsumerIf {
+  explicit RecordingConsumer(const double v) : voltage(v) {}
+
+  virtual double consume(const sc_core::sc_time &time,
+                         const double staticCurrent,
+                         const double dynamicEnergy) override {
+    calls++;
+    lastTime = time;
+    lastStaticCurrent = staticCurrent;
+    lastDynamicEnergy = dynamicEnergy;
+    return voltage;
+  }
+
+  double voltage;
+  unsigned int calls = 0;
+  sc_core::sc_time lastTime{sc_core::SC_ZERO_TIME};
+  double lastStaticCurrent = 0.0;
+  double lastDynamicEnergy = 0.0;
+};
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <memory>
+#include <systemc>
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/DmiEnergyAccountant.hpp"
+#include "ps/PowerModelChannel.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  PowerModelChannel ch{"ch", "none"};
+  sc_port<PowerModelChannelInIf> inport{"inport"};
+  DmiEnergyAccountant dmi{"dmi"};
+
+  SC_CTOR(tester) {
+    inport(ch);
+    dmi.powerModelPort(ch);
+    readId = ch.registerEvent(
+        "ram", std::make_shared<ConstantEnergyEvent>("read", 1.0e-12));
+    writeId = ch.registerEvent(
+        "ram", std::make_shared<ConstantEnergyEvent>("write", 2.0e-12));
+    ram = dmi.addRegion(0x2000, 0x2fff, readId, writeId);
+    rom = dmi.addRegion(0x0000, 0x0fff, readId, -1);
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    spdlog::info("------ TEST: Addresses map to regions");
+    sc_assert(dmi.findRegion(0x2100) == static_cast<int>(ram));
+    sc_assert(dmi.findRegion(0x0000) == static_cast<int>(rom));
+    sc_assert(dmi.findRegion(0x1000) == -1);
+
+    spdlog::info("------ TEST: Counts are reported on flush only");
+    for (int i = 0; i < 100; ++i) {
+      dmi.read(ram);
+      dmi.read(rom);
+    }
+    dmi.write(ram, 10);
+    dmi.write(rom, 10);
+    sc_assert(inport->popEventCount(readId) == 0);
+    dmi.flush();
+    sc_assert(inport->popEventCount(readId) == 200);
+    sc_assert(inport->popEventCount(writeId) == 10);
+
+    spdlog::info("------ TEST: Invalidation flushes and drops regions");
+    dmi.read(ram, 5);
+    dmi.invalidate(0x2800, 0x28ff);
+    sc_assert(inport->popEventCount(readId) == 5);
+    sc_assert(dmi.findRegion(0x2100) == -1);
+
+    sc_stop();
+  }
+
+  int readId;
+  int writeId;
+  unsigned int ram;
+  unsigned int rom;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
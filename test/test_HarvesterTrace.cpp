@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <systemc>
+#include "ps/HarvesterTrace.hpp"
+#include "ps/HarvesterTracePlayer.hpp"
+
+using namespace sc_core;
+
+namespace {
+const std::string csvPath = "/tmp/test_HarvesterTrace.csv";
+const std::string tracePath = "/tmp/test_HarvesterTrace.htr";
+
+bool near(const double a, const double b) {
+  return std::fabs(a - b) <= 1e-9 * std::fabs(b);
+}
+} // namespace
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  {
+    std::ofstream f(csvPath, std::ios::out | std::ios::trunc);
+    f << "time,power\n"
+         "0.0,0.0\n"
+         "1.0,1.0e-3\n"
+         "2.0,1.0e-3\n"
+         "3.0,1.0e-4\n";
+  }
+
+  spdlog::info("------ TEST: csv converts to a binary trace");
+  HarvesterTrace::convertCsv(csvPath, tracePath);
+  {
+    const HarvesterTrace trace(tracePath);
+    sc_assert(trace.size() == 4);
+    sc_assert(trace[3].time == 3.0);
+
+    spdlog::info("------ TEST: Power is interpolated between samples");
+    sc_assert(near(trace.powerAt(0.5), 0.5e-3));
+    sc_assert(near(trace.powerAt(2.5), 0.55e-3));
+    sc_assert(trace.powerAt(10.0) == 1.0e-4);
+    sc_assert(trace.segment(1.5) == 1);
+  }
+
+  spdlog::info("------ TEST: Unsorted csv is rejected");
+  {
+    std::ofstream f(csvPath, std::ios::out | std::ios::trunc);
+    f << "0.0,0.0\n1.0,1.0\n0.5,1.0\n";
+  }
+  auto success = false;
+  try {
+    HarvesterTrace::convertCsv(csvPath, "/tmp/test_HarvesterTrace_bad.htr");
+  } catch (const std::invalid_argument &e) {
+    success = true;
+  }
+  sc_assert(success);
+
+  spdlog::info("------ TEST: Non-positive tolerance is rejected");
+  for (const double tolerance : {0.0, -1.0e-3, std::nan("")}) {
+    success = false;
+    try {
+      HarvesterTracePlayer bad("bad", tracePath, tolerance);
+    } catch (const std::invalid_argument &e) {
+      success = true;
+    }
+    sc_assert(success);
+  }
+
+  spdlog::info("------ TEST: Player only wakes up on significant changes");
+  // Updates at 0 s, on the ramp at 0.35 mW & 0.7 mW, then once on the way
+  // down at 0.35 mW
+  HarvesterTracePlayer player("player", tracePath, 0.35e-3);
+  sc_start(10, SC_SEC);
+  sc_assert(player.updateCount() == 4);
+  sc_assert(near(player.getPower(), 0.35e-3));
+
+  std::remove(csvPath.c_str());
+  std::remove(tracePath.c_str());
+  return 0;
+}
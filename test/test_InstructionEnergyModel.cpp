@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <systemc>
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/InstructionEnergyModel.hpp"
+#include "ps/PowerModelChannel.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  PowerModelChannel ch{"ch", "none"};
+  sc_port<PowerModelChannelInIf> inport{"inport"};
+  InstructionEnergyModel iem{"iem"};
+
+  SC_CTOR(tester) {
+    inport(ch);
+    iem.powerModelPort(ch);
+    alu = iem.addClass(std::make_shared<ConstantEnergyEvent>("alu", 1.0e-12));
+    load = iem.addClass(std::make_shared<ConstantEnergyEvent>("load", 4.0e-12));
+    toggle = iem.addCorrection(
+        std::make_shared<ConstantEnergyEvent>("operandToggle", 0.1e-12));
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    // Block at 0x100: alu, load, alu
+    const unsigned int block0[3] = {alu, load, alu};
+    unsigned int classified = 0;
+    auto classify = [&](unsigned int i) {
+      classified++;
+      return block0[i];
+    };
+
+    spdlog::info("------ TEST: Blocks are classified once");
+    for (int i = 0; i < 10; ++i) {
+      iem.executeBlock(0x100, 3, classify);
+    }
+    sc_assert(classified == 3);
+    sc_assert(iem.getBlockCount() == 1);
+
+    spdlog::info("------ TEST: Counts are reported on flush only");
+    sc_assert(inport->popDynamicEnergy() == 0.0);
+    iem.correct(toggle, 10);
+    iem.flush();
+    sc_assert(iem.getInstructionCount() == 30);
+    sc_assert(std::abs(inport->popDynamicEnergy() -
+                       (20 * 1.0e-12 + 10 * 4.0e-12 + 10 * 0.1e-12)) < 1e-24);
+
+    spdlog::info("------ TEST: Invalidated blocks are classified again");
+    iem.invalidateBlocks();
+    iem.executeBlock(0x100, 3, classify);
+    sc_assert(classified == 6);
+    iem.flush();
+    sc_assert(iem.getInstructionCount() == 33);
+
+    sc_stop();
+  }
+
+  unsigned int alu;
+  unsigned int load;
+  unsigned int toggle;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
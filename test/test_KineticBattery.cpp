@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <systemc>
+#include "ps/KineticBattery.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  sc_signal<double> iLoad{"iLoad", 0.0};
+  sc_signal<double> vcc{"vcc"};
+  // 1 Ah, half of it readily available
+  KineticBattery battery{"battery", /*capacity=*/3600.0, /*c=*/0.5,
+                         /*k=*/1.0e-4, /*vFull=*/3.0, /*vEmpty=*/2.0};
+
+  SC_CTOR(tester) {
+    battery.i_load.bind(iLoad);
+    battery.v_out.bind(vcc);
+    half = battery.addThreshold(0.5);
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    spdlog::info("------ TEST: Battery at rest keeps its charge");
+    wait(1, SC_SEC);
+    sc_assert(battery.getStateOfCharge() == 1.0);
+    sc_assert(vcc.read() == 3.0);
+
+    spdlog::info("------ TEST: State-of-charge threshold crossed on time");
+    // 1 A drains half of 3600 C in 1800 s
+    iLoad.write(1.0);
+    const auto start = sc_time_stamp();
+    wait(battery.thresholdEvent(half));
+    sc_assert(std::abs((sc_time_stamp() - start).to_seconds() - 1800.0) <
+              1.0e-6);
+    sc_assert(std::abs(battery.getStateOfCharge() - 0.5) < 1.0e-9);
+
+    spdlog::info("------ TEST: Available well runs empty before total charge");
+    wait(battery.emptyEvent());
+    sc_assert(battery.isDepleted());
+    sc_assert(battery.getAvailableCharge() == 0.0);
+    sc_assert(battery.getStateOfCharge() > 0.0);
+    sc_assert(battery.getVoltage() == 0.0);
+
+    sc_stop();
+  }
+
+  int half;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <systemc>
+#include "ps/LookupTableBank.hpp"
+#include "ps/LookupTableCurrentState.hpp"
+#include "ps/LookupTableEnergyEvent.hpp"
+
+namespace {
+bool near(const double a, const double b) {
+  return std::fabs(a - b) <= 1e-12 * std::fabs(b);
+}
+} // namespace
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  auto bank =
+      std::make_shared<LookupTableBank>(std::vector<double>{1.8, 2.4, 3.0});
+  const LookupTableEnergyEvent read("read", bank, {1.0e-9, 2.0e-9, 4.0e-9});
+  const LookupTableCurrentState run("run", bank, {1.0e-3, 1.6e-3, 2.2e-3});
+
+  spdlog::info("------ TEST: Values at grid points");
+  sc_assert(near(read.calculateEnergy(2.4), 2.0e-9));
+  sc_assert(near(run.calculateCurrent(2.4), 1.6e-3));
+
+  spdlog::info("------ TEST: Linear interpolation between grid points");
+  bank->setVoltage(2.7);
+  sc_assert(near(read.calculateEnergy(2.7), 3.0e-9));
+  sc_assert(near(run.calculateCurrent(2.7), 1.9e-3));
+
+  spdlog::info("------ TEST: Values are clamped outside the grid");
+  sc_assert(near(read.calculateEnergy(1.0), 1.0e-9));
+  sc_assert(near(run.calculateCurrent(3.6), 2.2e-3));
+
+  spdlog::info("------ TEST: Bilinear interpolation over voltage & temperature");
+  auto bank2 = std::make_shared<LookupTableBank>(std::vector<double>{1.0, 2.0},
+                                                 std::vector<double>{0, 100});
+  const LookupTableCurrentState leak("leak", bank2, {1.0, 3.0, 2.0, 6.0});
+  bank2->setTemperature(50);
+  sc_assert(near(leak.calculateCurrent(1.0), 2.0));
+  sc_assert(near(leak.calculateCurrent(1.5), 3.0));
+
+  spdlog::info("------ TEST: Table size mismatch throws");
+  auto success = false;
+  try {
+    bank->addTable({1.0, 2.0});
+  } catch (const std::invalid_argument &e) {
+    success = true;
+  }
+  sc_assert(success);
+
+  spdlog::info("------ TEST: Non-increasing grid throws");
+  success = false;
+  try {
+    LookupTableBank({1.0, 1.0});
+  } catch (const std::invalid_argument &e) {
+    success = true;
+  }
+  sc_assert(success);
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <systemc>
+#include <vector>
+#include "ps/ConstantCurrentState.hpp"
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/MultiRailBridge.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "RecordingConsumer.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  PowerModelChannel cpu{"cpu", "none"};
+  PowerModelChannel radio{"radio", "none"};
+  MultiRailBridge bridge{"bridge", sc_time(1, SC_US)};
+
+  SC_CTOR(tester) {
+    cpuOn = cpu.registerState(
+        "core", std::make_shared<ConstantCurrentState>("on", 1.0e-3));
+    cpuOp = cpu.registerEvent(
+        "core", std::make_shared<ConstantEnergyEvent>("op", 1.0e-9));
+    radioOn = radio.registerState(
+        "rf", std::make_shared<ConstantCurrentState>("on", 2.0e-3));
+    radioTx = radio.registerEvent(
+        "rf", std::make_shared<ConstantEnergyEvent>("tx", 4.0e-9));
+    bridge.powerModelPorts(cpu);
+    bridge.powerModelPorts(radio);
+    bridge.setCallback([this](const std::vector<double> &currents) {
+      callbacks++;
+      lastCurrents = currents;
+    });
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    spdlog::info("------ TEST: Rail voltages are forwarded to the channels");
+    bridge.setRailVoltage(0, 1.0);
+    bridge.setRailVoltage(1, 2.0);
+    bridge.setRailConsumer(1, &consumer);
+    sc_assert(cpu.getSupplyVoltage() == 1.0);
+    sc_assert(radio.getSupplyVoltage() == 2.0);
+
+    cpu.reportState(cpuOn);
+    radio.reportState(radioOn);
+    cpu.reportEvent(cpuOp, 3);
+    radio.reportEvent(radioTx, 2);
+    wait(1500, SC_NS);
+
+    spdlog::info("------ TEST: One pass updates the current of every rail");
+    sc_assert(callbacks == 1);
+    sc_assert(lastCurrents.size() == 2);
+    sc_assert(lastCurrents == bridge.currents());
+    // Static current + E / (v * ts)
+    sc_assert(std::abs(lastCurrents[0] - (cpu.getStaticCurrent() +
+                                          3.0e-9 / (1.0 * 1.0e-6))) < 1e-12);
+    sc_assert(std::abs(cpu.getEventEnergyTotal(cpuOp) - 3.0e-9) < 1e-18);
+
+    spdlog::info("------ TEST: The rail consumer gets the channel's draw");
+    sc_assert(consumer.calls == 1);
+    sc_assert(consumer.lastTime == sc_time(1, SC_US));
+    sc_assert(std::abs(consumer.lastStaticCurrent -
+                       radio.getStaticCurrent()) < 1e-12);
+    sc_assert(std::abs(consumer.lastDynamicEnergy - 8.0e-9) < 1e-18);
+    sc_assert(std::abs(consumer.lastDynamicEnergy -
+                       radio.getEventEnergyTotal(radioTx)) < 1e-18);
+    sc_assert(std::abs(lastCurrents[1] - (2.0e-3 + 8.0e-9 / (2.0 * 1.0e-6))) <
+              1e-12);
+
+    spdlog::info("------ TEST: The consumer's voltage is applied to the rail");
+    sc_assert(radio.getSupplyVoltage() == consumer.voltage);
+
+    spdlog::info("------ TEST: Energy is popped once per timestep");
+    wait(1, SC_US);
+    sc_assert(callbacks == 2);
+    sc_assert(std::abs(lastCurrents[0] - 1.0e-3) < 1e-12);
+    sc_assert(consumer.calls == 2);
+    sc_assert(consumer.lastDynamicEnergy == 0.0);
+    sc_assert(std::abs(lastCurrents[1] - 2.0e-3) < 1e-12);
+
+    sc_stop();
+  }
+
+  RecordingConsumer consumer{2.5};
+  unsigned int callbacks = 0;
+  std::vector<double> lastCurrents;
+  int cpuOn;
+  int cpuOp;
+  int radioOn;
+  int radioTx;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <systemc>
+#include "ps/OperatingPointCurrentState.hpp"
+#include "ps/OperatingPointEnergyEvent.hpp"
+#include "ps/OperatingPointTable.hpp"
+#include "ps/PowerModelChannel.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  PowerModelChannel ch{"ch", "none"};
+  PowerModelChannel multi{"multi", "none"};
+  std::shared_ptr<OperatingPointTable> points =
+      std::make_shared<OperatingPointTable>(
+          std::vector<OperatingPointTable::OperatingPoint>{{0.9, 100.0e6},
+                                                           {1.2, 400.0e6}});
+
+  SC_CTOR(tester) {
+    eid = ch.registerEvent("cpu", std::make_shared<OperatingPointEnergyEvent>(
+                                      "instruction", points,
+                                      std::vector<double>{1.0e-12, 3.0e-12}));
+    sid = ch.registerState("cpu", std::make_shared<OperatingPointCurrentState>(
+                                      "run", points,
+                                      std::vector<double>{1.0e-3, 4.0e-3}));
+    checkDomains();
+    SC_THREAD(runtests);
+  }
+
+  //! Misconfigurations are rejected, then undone so simulation can start
+  void checkDomains() {
+    auto a = std::make_shared<OperatingPointTable>(
+        std::vector<OperatingPointTable::OperatingPoint>{{0.9, 100.0e6},
+                                                         {1.2, 400.0e6}});
+    auto b = std::make_shared<OperatingPointTable>(
+        std::vector<OperatingPointTable::OperatingPoint>{{1.0, 100.0e6},
+                                                         {1.1, 200.0e6}});
+    multi.registerState("cpu", std::make_shared<OperatingPointCurrentState>(
+                                 "run", a, std::vector<double>{1.0, 2.0}));
+    multi.registerState("dsp", std::make_shared<OperatingPointCurrentState>(
+                                 "run", a, std::vector<double>{1.0, 2.0}));
+    multi.registerState("radio", std::make_shared<OperatingPointCurrentState>(
+                                   "run", b, std::vector<double>{1.0, 2.0}));
+    const auto rf = multi.addVoltageDomain("rf");
+    const auto dsp = multi.addVoltageDomain("dsp");
+    multi.setModuleDomain("radio", rf);
+
+    spdlog::info("------ TEST: A table can not be shared across domains");
+    multi.setModuleDomain("dsp", dsp);
+    sharedRejected = throws([this] { multi.setOperatingPoint(1); });
+    multi.setModuleDomain("dsp", 0);
+
+    spdlog::info("------ TEST: Tables of a domain must have the same points");
+    multi.setModuleDomain("radio", 0);
+    mismatchRejected = throws([this] { multi.setOperatingPoint(1); });
+    multi.setModuleDomain("radio", rf);
+  }
+
+  template <typename F> static bool throws(F f) {
+    try {
+      f();
+    } catch (const std::invalid_argument &) {
+      return true;
+    }
+    return false;
+  }
+
+  void runtests() {
+    sc_assert(sharedRejected);
+    sc_assert(mismatchRejected);
+
+    spdlog::info("------ TEST: Operating point sets voltage and tables");
+    ch.setOperatingPoint(0);
+    ch.reportState(sid);
+    sc_assert(ch.getSupplyVoltage() == 0.9);
+    sc_assert(ch.getEventEnergy(eid) == 1.0e-12);
+    sc_assert(ch.getStaticCurrent() == 1.0e-3);
+
+    spdlog::info("------ TEST: State energy follows the operating point");
+    wait(1, SC_US);
+    ch.setOperatingPoint(1);
+    sc_assert(ch.getSupplyVoltage() == 1.2);
+    sc_assert(ch.getEventEnergy(eid) == 3.0e-12);
+    sc_assert(ch.getStaticCurrent() == 4.0e-3);
+    wait(1, SC_US);
+    sc_assert(std::abs(ch.getTotalEnergy() - (0.9e-9 + 4.8e-9)) < 1.0e-18);
+
+    spdlog::info("------ TEST: Domains select their points independently");
+    multi.setOperatingPoint(1);
+    multi.setOperatingPoint(0, 1);
+    sc_assert(multi.getSupplyVoltage() == 1.2);
+    sc_assert(multi.getSupplyVoltage(1) == 1.0);
+
+    sc_stop();
+  }
+
+  int eid;
+  int sid;
+  bool sharedRejected = false;
+  bool mismatchRejected = false;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <memory>
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/simple_target_socket.h>
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/PowerAnnotatingSocket.hpp"
+#include "ps/PowerModelChannel.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(Memory) {
+  tlm_utils::simple_target_socket<Memory> socket{"socket"};
+  unsigned int accesses = 0;
+
+  SC_CTOR(Memory) { socket.register_b_transport(this, &Memory::b_transport); }
+
+  void b_transport(tlm::tlm_generic_payload & trans,
+                   [[maybe_unused]] sc_time & delay) {
+    ++accesses;
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  tlm_utils::simple_initiator_socket<tester> socket{"socket"};
+  tlm_utils::simple_initiator_socket<tester> unboundSocket{"unboundSocket"};
+  PowerModelChannel ch{"ch", "none"};
+  sc_port<PowerModelChannelInIf> inport{"inport"};
+  PowerAnnotatingSocket<32> annotator{"annotator"};
+  PowerAnnotatingSocket<32> passthrough{"passthrough"};
+  Memory mem{"mem"};
+  Memory mem2{"mem2"};
+
+  SC_CTOR(tester) {
+    inport(ch);
+    socket(annotator.target_socket);
+    annotator.initiator_socket(mem.socket);
+    annotator.powerModelPort(ch);
+    unboundSocket(passthrough.target_socket);
+    passthrough.initiator_socket(mem2.socket);
+
+    read = annotator.addEventClass(
+        tlm::TLM_READ_COMMAND, 1, 1.0,
+        std::make_shared<ConstantEnergyEvent>("read", 1.0e-12));
+    burst = annotator.addEventClass(
+        tlm::TLM_READ_COMMAND, 8, 1.0,
+        std::make_shared<ConstantEnergyEvent>("read burst", 4.0e-12));
+    write = annotator.addEventClass(
+        tlm::TLM_WRITE_COMMAND, 1, 1.0,
+        std::make_shared<ConstantEnergyEvent>("write", 2.0e-12));
+    partialWrite = annotator.addEventClass(
+        tlm::TLM_WRITE_COMMAND, 1, 0.5,
+        std::make_shared<ConstantEnergyEvent>("write half", 3.0e-12));
+    sparseWrite = annotator.addEventClass(
+        tlm::TLM_WRITE_COMMAND, 1, 0.25,
+        std::make_shared<ConstantEnergyEvent>("write quarter", 2.5e-12));
+    ch.setTemporalDecoupling(sc_time(1, SC_US));
+    SC_THREAD(runtests);
+  }
+
+  void access(tlm_utils::simple_initiator_socket<tester> & s,
+              const tlm::tlm_command cmd, const unsigned int length,
+              unsigned char *byteEnables = nullptr,
+              sc_time delay = SC_ZERO_TIME) {
+    tlm::tlm_generic_payload trans;
+    trans.set_command(cmd);
+    trans.set_data_ptr(m_data);
+    trans.set_data_length(length);
+    trans.set_byte_enable_ptr(byteEnables);
+    trans.set_byte_enable_length(byteEnables != nullptr ? length : 0);
+    s->b_transport(trans, delay);
+  }
+
+  void runtests() {
+    spdlog::info("------ TEST: Transactions are forwarded");
+    access(socket, tlm::TLM_READ_COMMAND, 4);
+    access(unboundSocket, tlm::TLM_READ_COMMAND, 4);
+    sc_assert(mem.accesses == 1);
+    sc_assert(mem2.accesses == 1);
+
+    spdlog::info("------ TEST: Transactions are classified and batched");
+    access(socket, tlm::TLM_READ_COMMAND, 4);
+    access(socket, tlm::TLM_READ_COMMAND, 16);
+    access(socket, tlm::TLM_WRITE_COMMAND, 4);
+    unsigned char half[4] = {0xff, 0x00, 0x00, 0xff};
+    access(socket, tlm::TLM_WRITE_COMMAND, 4, half);
+    // Nothing is reported until the end of the delta cycle
+    sc_assert(inport->popEventCount(eventId(read)) == 0);
+    wait(SC_ZERO_TIME);
+    wait(SC_ZERO_TIME);
+    sc_assert(inport->popEventCount(eventId(read)) == 2);
+    sc_assert(inport->popEventCount(eventId(burst)) == 1);
+    sc_assert(inport->popEventCount(eventId(write)) == 1);
+    sc_assert(inport->popEventCount(eventId(partialWrite)) == 1);
+
+    spdlog::info("------ TEST: Byte-enable density picks the narrowest class");
+    unsigned char quarter[4] = {0x00, 0x00, 0xff, 0x00};
+    unsigned char threeQuarters[4] = {0xff, 0x00, 0xff, 0xff};
+    unsigned char none[4] = {0x00, 0x00, 0x00, 0x00};
+    access(socket, tlm::TLM_WRITE_COMMAND, 4, quarter);
+    access(socket, tlm::TLM_WRITE_COMMAND, 4, none);
+    access(socket, tlm::TLM_WRITE_COMMAND, 4, threeQuarters);
+    wait(SC_ZERO_TIME);
+    wait(SC_ZERO_TIME);
+    sc_assert(inport->popEventCount(eventId(sparseWrite)) == 2);
+    sc_assert(inport->popEventCount(eventId(partialWrite)) == 0);
+    // No class up to 3/4, counted as a full write
+    sc_assert(inport->popEventCount(eventId(write)) == 1);
+
+    spdlog::info("------ TEST: Annotated delays are reported as offsets");
+    access(socket, tlm::TLM_READ_COMMAND, 4, nullptr, sc_time(2.5, SC_US));
+    wait(SC_ZERO_TIME);
+    wait(SC_ZERO_TIME);
+    sc_assert(inport->popEventCount(eventId(read)) == 0);
+    wait(3, SC_US);
+    sc_assert(inport->popEventCount(eventId(read)) == 1);
+
+    sc_stop();
+  }
+
+  //! Event ids are assigned in class order, the channel has no other events
+  int eventId(const unsigned int classId) const { return classId; }
+
+  unsigned char m_data[64];
+  unsigned int read;
+  unsigned int burst;
+  unsigned int write;
+  unsigned int partialWrite;
+  unsigned int sparseWrite;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <systemc>
+#include "ps/ConstantCurrentState.hpp"
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/PowerModelBridge.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "RecordingConsumer.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  //! Identical models, one coupled through signals, one through a consumer
+  PowerModelChannel signalCh{"signalCh", "none"};
+  PowerModelChannel consumerCh{"consumerCh", "none"};
+  PowerModelBridge signalBridge{"signalBridge", sc_time(1, SC_US)};
+  PowerModelBridge consumerBridge{"consumerBridge", sc_time(1, SC_US)};
+  sc_signal<double> v{"v"};
+  sc_signal<double> i{"i"};
+
+  SC_CTOR(tester) {
+    for (auto ch : {&signalCh, &consumerCh}) {
+      on = ch->registerState(
+          "core", std::make_shared<ConstantCurrentState>("on", 1.0e-3));
+      op = ch->registerEvent(
+          "core", std::make_shared<ConstantEnergyEvent>("op", 1.0e-9));
+    }
+    signalBridge.powerModelPort(signalCh);
+    signalBridge.v_in(v);
+    signalBridge.i_out(i);
+    consumerBridge.powerModelPort(consumerCh);
+    consumerBridge.setConsumer(&consumer);
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    v.write(1.0);
+    consumerCh.setSupplyVoltage(1.0);
+    for (auto ch : {&signalCh, &consumerCh}) {
+      ch->reportState(on);
+      ch->reportEvent(op, 3);
+    }
+    wait(1500, SC_NS);
+
+    spdlog::info("------ TEST: i_out is static current + E / (v * ts)");
+    sc_assert(std::abs(i.read() - (1.0e-3 + 3.0e-9 / (1.0 * 1.0e-6))) <
+              1e-12);
+
+    spdlog::info("------ TEST: The consumer gets the same draw");
+    sc_assert(consumer.calls == 1);
+    sc_assert(consumer.lastTime == sc_time(1, SC_US));
+    sc_assert(std::abs(consumer.lastStaticCurrent - 1.0e-3) < 1e-12);
+    sc_assert(std::abs(consumer.lastDynamicEnergy - 3.0e-9) < 1e-18);
+    const double current = consumer.lastStaticCurrent +
+                           consumer.lastDynamicEnergy / (1.0 * 1.0e-6);
+    sc_assert(std::abs(current - i.read()) < 1e-12);
+
+    spdlog::info("------ TEST: The consumer's voltage is applied");
+    sc_assert(consumerCh.getSupplyVoltage() == consumer.voltage);
+
+    spdlog::info("------ TEST: Event energy is popped once");
+    wait(1, SC_US);
+    sc_assert(consumer.calls == 2);
+    sc_assert(consumer.lastDynamicEnergy == 0.0);
+    sc_assert(std::abs(i.read() - 1.0e-3) < 1e-12);
+
+    sc_stop();
+  }
+
+  RecordingConsumer consumer{1.2};
+  int on;
+  int op;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
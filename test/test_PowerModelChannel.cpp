@@ -6,12 +6,14 @@
  */
 
 #include <spdlog/spdlog.h>
+#include <cmath>
 #include <stdexcept>
 #include <string>
 #include <systemc>
 #include "libs/make_unique.hpp"
 #include "ps/ConstantCurrentState.hpp"
 #include "ps/ConstantEnergyEvent.hpp"
+#include "ps/HistoryEnergyEvent.hpp"
 #include "ps/PowerModelChannel.hpp"
 #include "ps/PowerModelChannelIf.hpp"
 
@@ -33,6 +35,12 @@ SC_MODULE(tester) {
   SC_CTOR(tester) {
     registerEvents();
     registerStates();
+    registerWatchers();
+    plainEvent = plain.registerEvent(
+        "module0", std::make_unique<ConstantEnergyEvent>("event", 1.0e-12));
+    decoupledEvent = decoupled.registerEvent(
+        "module0", std::make_unique<ConstantEnergyEvent>("event", 1.0e-12));
+    decoupled.setTemporalDecoupling(sc_time(1, SC_US), 2);
     SC_THREAD(runtests);
   }
 
@@ -44,6 +52,11 @@ SC_MODULE(tester) {
     eid2 = test.outport->registerEvent(
         "module0", std::make_unique<ConstantEnergyEvent>("event2", 2.0e-12));
     sc_assert(eid2 == 1);
+    eid3 = test.outport->registerEvent(
+        "module0", std::make_shared<HistoryEnergyEvent>(
+                       HistoryEnergyEvent::lastSymbol("rowAccess", 4, 1.0e-12,
+                                                      5.0e-12)));
+    sc_assert(eid3 == 2);
 
     spdlog::info(
         "------ TEST: registering the same event twice throws exception");
@@ -83,6 +96,18 @@ SC_MODULE(tester) {
       success = true;
     }
     sc_assert(success);
+
+    spdlog::info("------ TEST: register a state transition");
+    test.outport->registerStateTransition(sid3, sid4, 7.0e-12,
+                                          sc_time(3, SC_US));
+  }
+
+  void registerWatchers() {
+    spdlog::info("------ TEST: register some watchers");
+    pwid = test.outport->registerPowerWatcher(1.5e-6);
+    sc_assert(pwid == 0);
+    ewid = test.outport->registerEnergyWatcher(5.0e-12);
+    sc_assert(ewid == 1);
   }
 
   void runtests() {
@@ -131,15 +156,175 @@ SC_MODULE(tester) {
     test.outport->reportState(sid3);
     sc_assert(test.inport->getStaticCurrent() == 0.0);
 
+    spdlog::info("------ TEST: Popped event energy accumulates");
+    const auto mid0 = test.outport->getModuleId("module0");
+    sc_assert(mid0 == 0);
+    sc_assert(test.outport->getModuleId("nonexistent") == -1);
+    const double eventEnergy = test.outport->getEventEnergyTotal(eid1);
+    const double totalEnergy = test.outport->getTotalEnergy();
+    test.outport->reportEvent(eid1, 2);
+    test.inport->popDynamicEnergy();
+    sc_assert(std::abs(test.outport->getEventEnergyTotal(eid1) - eventEnergy -
+                       2.0e-12) < 1.0e-18);
+    sc_assert(std::abs(test.outport->getTotalEnergy() - totalEnergy -
+                       2.0e-12) < 1.0e-18);
+
+    spdlog::info("------ TEST: State energy integrates over time");
+    test.inport->setSupplyVoltage(1.0);
+    const double moduleEnergy = test.outport->getModuleEnergy(mid0);
+    test.outport->reportState(sid2);
+    wait(1, SC_US);
+    sc_assert(std::abs(test.outport->getModuleEnergy(mid0) - moduleEnergy -
+                       1.0e-12) < 1.0e-18);
+    test.outport->reportState(sid1);
+
+    spdlog::info("------ TEST: Power watcher fires when power exceeds threshold");
+    test.outport->reportState(sid2);
+    test.outport->reportState(sid4);
+    wait(test.outport->watcherEvent(pwid));
+
+    spdlog::info("------ TEST: Energy watcher fires at predicted crossing");
+    test.outport->rearmWatcher(ewid);
+    const auto armTime = sc_time_stamp();
+    wait(test.outport->watcherEvent(ewid));
+    sc_assert(std::abs((sc_time_stamp() - armTime).to_seconds() -
+                       5.0e-12 / 3.0e-6) < 1.0e-12);
+    test.outport->reportState(sid1);
+    test.outport->reportState(sid3);
+
+    spdlog::info("------ TEST: Decoupled events are held until their interval");
+    test.outport->reportEvent(eid1, 3, sc_time(2.5, SC_US));
+    sc_assert(test.inport->popEventCount(eid1) == 0);
+    wait(1, SC_US);
+    sc_assert(test.inport->popEventCount(eid1) == 0);
+    wait(3, SC_US);
+    sc_assert(test.inport->popEventCount(eid1) == 3);
+
+    spdlog::info("------ TEST: Scheduled states are applied on time");
+    test.outport->scheduleState(sid2, sc_time(2, SC_US));
+    test.outport->scheduleState(sid1, sc_time(5, SC_US));
+    wait(3, SC_US);
+    sc_assert(test.inport->getStaticCurrent() == 1.0e-6);
+    wait(3, SC_US);
+    sc_assert(test.inport->getStaticCurrent() == 0.0);
+
+    spdlog::info("------ TEST: Cancelled states are not applied");
+    test.outport->scheduleState(sid4, sc_time(1, SC_US));
+    test.outport->cancelScheduledStates(sid3);
+    wait(2, SC_US);
+    sc_assert(test.inport->getStaticCurrent() == 0.0);
+
+    spdlog::info("------ TEST: State transitions charge their energy");
+    test.inport->popDynamicEnergy();
+    test.outport->reportState(sid4);
+    sc_assert(test.inport->popDynamicEnergy() == 7.0e-12);
+    test.outport->reportState(sid4);
+    test.outport->reportState(sid3);
+    sc_assert(test.inport->popDynamicEnergy() == 0.0);
+    sc_assert(test.outport->getStateTransitionLatency(sid3, sid4) ==
+              sc_time(3, SC_US));
+    sc_assert(test.outport->getStateTransitionLatency(sid4, sid3) ==
+              SC_ZERO_TIME);
+
+    spdlog::info("------ TEST: History events charge by their state");
+    test.outport->reportHistoryEvent(eid3, 2);    // miss
+    test.outport->reportHistoryEvent(eid3, 2, 3); // 3 hits
+    test.outport->reportHistoryEvent(eid3, 1);    // miss
+    sc_assert(test.inport->popEventCount(eid3) == 5);
+    test.outport->reportHistoryEvent(eid3, 1);    // hit
+    test.outport->reportEvent(eid3, 1);           // symbol 0, miss
+    sc_assert(std::abs(test.inport->popDynamicEnergy() - 6.0e-12) < 1e-24);
+    sc_assert(std::abs(test.outport->getEventEnergyTotal(eid3) - 6.0e-12) <
+              1e-24);
+
+    spdlog::info("------ TEST: Plain and symbol reports keep their order");
+    test.outport->reportEvent(eid3, 1);        // symbol 0, hit
+    test.outport->reportHistoryEvent(eid3, 1); // miss
+    sc_assert(std::abs(test.inport->popDynamicEnergy() - 6.0e-12) < 1e-24);
+
+    spdlog::info("------ TEST: Data events count toggled bits");
+    test.outport->reportDataEvent(eid1, 0x0f, 0xf0, 8);
+    test.outport->reportDataEvent(eid1, 0x100, 0x000, 8); // above width
+    sc_assert(test.inport->popEventCount(eid1) == 8);
+    const uint64_t prev[2] = {0, 0};
+    const uint64_t beats[6] = {~0ull, 0x1, 0x3, 0x1, ~0ull, 0x7};
+    test.outport->reportDataEvent(eid1, prev, beats, 65);
+    sc_assert(test.inport->popEventCount(eid1) == 65);
+    // prev->beat0: 64 + 1, beat0->beat1: 62 + 0, beat1->beat2: 62 + 0
+    test.outport->reportDataBurst(eid1, prev, beats, 3, 65);
+    sc_assert(test.inport->popEventCount(eid1) == 189);
+    // Upper word unmasked, beat1->beat2: 62 + 2
+    test.outport->reportDataBurst(eid1, prev, beats, 3, 128);
+    sc_assert(test.inport->popEventCount(eid1) == 191);
+
+    spdlog::info("------ TEST: Energy is attributed to the current context");
+    const auto ctxA = test.outport->registerContext("taskA");
+    const auto ctxB = test.outport->registerContext("taskB");
+    sc_assert(test.outport->registerContext("taskA") == ctxA);
+    test.outport->setContext(ctxA);
+    test.outport->reportEvent(eid2, 1);
+    test.outport->reportHistoryEvent(eid3, 3); // miss
+    test.outport->setContext(ctxB);
+    test.outport->reportEvent(eid1, 3);
+    test.outport->setContext(0);
+    sc_assert(std::abs(test.outport->getContextEnergy(ctxA) - 7.0e-12) <
+              1e-24);
+    sc_assert(std::abs(test.outport->getContextEnergy(ctxB) - 3.0e-12) <
+              1e-24);
+
+    spdlog::info("------ TEST: Context energy is kept per event");
+    sc_assert(std::abs(test.outport->getContextEventEnergy(ctxA, eid2) -
+                       2.0e-12) < 1e-24);
+    sc_assert(std::abs(test.outport->getContextEventEnergy(ctxA, eid3) -
+                       5.0e-12) < 1e-24);
+    sc_assert(test.outport->getContextEventEnergy(ctxB, eid2) == 0.0);
+    test.inport->popDynamicEnergy();
+
+    spdlog::info("------ TEST: Quantized supply voltage moves with hysteresis");
+    test.ch.setVoltageQuantization(0.1, 0.02);
+    test.inport->setSupplyVoltage(1.04);
+    sc_assert(test.outport->getSupplyVoltage() == 1.0);
+    test.inport->setSupplyVoltage(1.06);
+    sc_assert(test.outport->getSupplyVoltage() == 1.0);
+    test.inport->setSupplyVoltage(1.08);
+    sc_assert(std::abs(test.outport->getSupplyVoltage() - 1.1) < 1.0e-12);
+    sc_assert(test.ch.getMaxQuantizationError() <=
+              test.ch.getQuantizationErrorBound());
+    test.outport->reportEvent(eid2, 2);
+    sc_assert(test.inport->popDynamicEnergy() == 2 * 2.0e-12);
+    test.ch.setVoltageQuantization(0.0);
+
+    spdlog::info("------ TEST: Offsets without a resolution are counted now");
+    plain.reportEvent(plainEvent, 2, sc_time(5, SC_US));
+    sc_assert(plain.popEventCount(plainEvent) == 2);
+    sc_assert(plain.getIgnoredOffsetReports() == 1);
+
+    spdlog::info("------ TEST: Offsets beyond the horizon are clamped, counted");
+    decoupled.reportEvent(decoupledEvent, 1, sc_time(10, SC_US));
+    decoupled.reportEvent(decoupledEvent, 1, sc_time(20, SC_US));
+    sc_assert(decoupled.getClampedOffsetReports() == 2);
+    sc_assert(decoupled.popEventCount(decoupledEvent) == 0);
+    wait(2, SC_US);
+    sc_assert(decoupled.popEventCount(decoupledEvent) == 2);
+
     sc_stop();
   }
 
+  //! No log timestep, so no decoupling resolution by default
+  PowerModelChannel plain{"plain", "none"};
+  PowerModelChannel decoupled{"decoupled", "none"};
+  int plainEvent;
+  int decoupledEvent;
+
   int eid1;
   int eid2;
+  int eid3;
   int sid1;
   int sid2;
   int sid3;
   int sid4;
+  int pwid;
+  int ewid;
 
   dut test{"dut"};
 };
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <systemc>
+#include "ps/ConstantCurrentState.hpp"
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/PowerModelDatabase.hpp"
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  const std::string path = "/tmp/test_PowerModelDatabase.yaml";
+  const std::string cachePath = path + ".pmdb";
+  const auto writeYaml = [&path](const std::string &read) {
+    std::ofstream f(path, std::ios::out | std::ios::trunc);
+    f << "memory:\n"
+         "  read: "
+      << read
+      << "\n"
+         "  on: 1.0e-4\n"
+         "\"cpu run\": 2.5e-3\n";
+  };
+  // Patch the cache header in place, keeping its size
+  const auto patchCache = [&cachePath](const std::streamoff offset,
+                                       const char *bytes, const size_t n) {
+    std::fstream f(cachePath, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(offset);
+    f.write(bytes, n);
+  };
+  const auto readCacheVersion = [&cachePath]() {
+    uint32_t version = 0;
+    std::ifstream f(cachePath, std::ios::binary);
+    f.seekg(8);
+    f.read(reinterpret_cast<char *>(&version), sizeof(version));
+    return version;
+  };
+  writeYaml("5.0e-11");
+  std::remove(cachePath.c_str());
+
+  auto &db = PowerModelDatabase::get();
+
+  spdlog::info("------ TEST: Nested and flat keys are loaded from YAML");
+  db.load(path);
+  sc_assert(db.size() == 3);
+  sc_assert(db.getDouble("memory read") == 5.0e-11);
+  sc_assert(db.getDouble("cpu run") == 2.5e-3);
+  sc_assert(!db.contains("memory write"));
+
+  spdlog::info("------ TEST: Missing keys throw");
+  auto success = false;
+  try {
+    db.getDouble("memory write");
+  } catch (std::out_of_range &e) {
+    success = true;
+  }
+  sc_assert(success);
+
+  spdlog::info("------ TEST: Reloading uses the binary cache");
+  sc_assert(std::ifstream(cachePath).good());
+  // Same size and mtime as the cached source, so only the cache can still
+  // hold the old value
+  struct stat src;
+  sc_assert(stat(path.c_str(), &src) == 0);
+  writeYaml("6.0e-11");
+  const struct timespec times[2] = {src.st_atim, src.st_mtim};
+  sc_assert(utimensat(AT_FDCWD, path.c_str(), times, 0) == 0);
+  db.clear();
+  db.load(path);
+  sc_assert(db.getDouble("memory read") == 5.0e-11);
+  sc_assert(db.getDouble("memory on") == 1.0e-4);
+
+  spdlog::info("------ TEST: Changing the YAML rebuilds the cache");
+  writeYaml("6.25e-11");
+  db.clear();
+  db.load(path);
+  sc_assert(db.getDouble("memory read") == 6.25e-11);
+  db.clear();
+  db.load(path);
+  sc_assert(db.getDouble("memory read") == 6.25e-11);
+
+  spdlog::info("------ TEST: Caches of another version are regenerated");
+  const uint32_t oldVersion = PowerModelDatabase::cacheVersion + 1;
+  patchCache(8, reinterpret_cast<const char *>(&oldVersion),
+             sizeof(oldVersion));
+  sc_assert(readCacheVersion() == oldVersion);
+  db.clear();
+  db.load(path);
+  sc_assert(db.getDouble("memory read") == 6.25e-11);
+  sc_assert(readCacheVersion() == PowerModelDatabase::cacheVersion);
+
+  spdlog::info("------ TEST: Caches with a bad magic are regenerated");
+  patchCache(0, "XXXX", 4);
+  db.clear();
+  db.load(path);
+  sc_assert(db.getDouble("memory read") == 6.25e-11);
+  char magic[8];
+  std::ifstream(cachePath, std::ios::binary).read(magic, sizeof(magic));
+  sc_assert(std::string(magic, 4) == "FUSE");
+
+  spdlog::info("------ TEST: Models look up their parameters");
+  sc_assert(ConstantEnergyEvent("memory", "read").energy == 6.25e-11);
+  sc_assert(ConstantCurrentState("memory", "on").current == 1.0e-4);
+  sc_assert(ConstantCurrentState("memory", "off").current == 0.0);
+
+  spdlog::info("------ TEST: Overrides take precedence");
+  db.set("memory read", 7.0e-11);
+  db.set("memory write", 9.0e-11);
+  sc_assert(db.getDouble("memory read") == 7.0e-11);
+  sc_assert(db.getDouble("memory write") == 9.0e-11);
+  sc_assert(db.getDouble("memory on") == 1.0e-4);
+
+  db.clear();
+  sc_assert(!db.contains("memory write"));
+  return false;
+}
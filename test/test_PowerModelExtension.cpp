@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/simple_target_socket.h>
+#include "ps/ConstantEnergyEvent.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "ps/PowerModelExtension.hpp"
+
+using namespace sc_core;
+
+//! Interconnect hop, annotates one hop event and forwards
+SC_MODULE(Router) {
+  tlm_utils::simple_target_socket<Router> target{"target"};
+  tlm_utils::simple_initiator_socket<Router> initiator{"initiator"};
+  int hopEventId = -1;
+
+  SC_CTOR(Router) { target.register_b_transport(this, &Router::b_transport); }
+
+  void b_transport(tlm::tlm_generic_payload & trans, sc_time & delay) {
+    PowerModelExtension::annotate(trans, hopEventId);
+    initiator->b_transport(trans, delay);
+  }
+};
+
+//! Terminating memory, annotates its access event and flushes
+SC_MODULE(Memory) {
+  tlm_utils::simple_target_socket<Memory> target{"target"};
+  PowerModelExtensionSink sink{"sink"};
+  int readEventId = -1;
+
+  SC_CTOR(Memory) { target.register_b_transport(this, &Memory::b_transport); }
+
+  void b_transport(tlm::tlm_generic_payload & trans,
+                   [[maybe_unused]] sc_time & delay) {
+    PowerModelExtension::annotate(trans, readEventId, 2);
+    sink.flush(trans);
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+  }
+};
+
+SC_MODULE(tester) {
+ public:
+  tlm_utils::simple_initiator_socket<tester> socket{"socket"};
+  PowerModelChannel ch{"ch", "none"};
+  sc_port<PowerModelChannelInIf> inport{"inport"};
+  Router router{"router"};
+  Memory mem{"mem"};
+
+  SC_CTOR(tester) {
+    inport(ch);
+    socket(router.target);
+    router.initiator(mem.target);
+    mem.sink.powerModelPort(ch);
+    router.hopEventId = ch.registerEvent(
+        "router", std::make_shared<ConstantEnergyEvent>("hop", 1.0e-12));
+    mem.readEventId = ch.registerEvent(
+        "mem", std::make_shared<ConstantEnergyEvent>("read", 5.0e-12));
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    ch.setSupplyVoltage(1.0);
+
+    spdlog::info("------ TEST: Energy accumulates along the path");
+    PowerModelExtension ext;
+    tlm::tlm_generic_payload trans;
+    trans.set_command(tlm::TLM_READ_COMMAND);
+    trans.set_data_ptr(m_data);
+    trans.set_data_length(4);
+    trans.set_extension(&ext);
+    sc_time delay = SC_ZERO_TIME;
+    for (int i = 0; i < 2; ++i) {
+      ext.reset(/*initiator=*/1);
+      socket->b_transport(trans, delay);
+      sc_assert(std::fabs(ext.energy - 11.0e-12) < 1.0e-18);
+      sc_assert(ext.events().empty());
+    }
+    trans.clear_extension(&ext);
+
+    spdlog::info("------ TEST: Sink reports in batch and tracks initiators");
+    sc_assert(inport->popEventCount(router.hopEventId) == 2);
+    sc_assert(inport->popEventCount(mem.readEventId) == 4);
+    sc_assert(mem.sink.getInitiatorTransactions(1) == 2);
+    sc_assert(std::fabs(mem.sink.getInitiatorEnergy(1) - 22.0e-12) < 1.0e-18);
+    sc_assert(mem.sink.getInitiatorEnergy(0) == 0.0);
+
+    sc_stop();
+  }
+
+  unsigned char m_data[4];
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <systemc>
+#include "ps/PowerSupplies.hpp"
+#include "ps/StorageCapacitor.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  sc_signal<double> iLoad{"iLoad", 0.0};
+  sc_signal<double> vcc{"vcc"};
+  StorageCapacitor ccCap{"ccCap", /*C=*/1.0e-3, /*v0=*/0.0,
+                         ConstantCurrentSupply(1.0e-3, 3.0)};
+
+  sc_signal<double> iLoadCp{"iLoadCp", 0.0};
+  sc_signal<double> vccCp{"vccCp"};
+  StorageCapacitor cpCap{"cpCap", /*C=*/1.0e-3, /*v0=*/1.0,
+                         ConstantPowerSupply(1.0e-3, 1.0e-2, 5.0)};
+
+  SC_CTOR(tester) {
+    ccCap.i_load.bind(iLoad);
+    ccCap.v_out.bind(vcc);
+    cpCap.i_load.bind(iLoadCp);
+    cpCap.v_out.bind(vccCp);
+    th1 = ccCap.addThreshold(1.0);
+    th2 = cpCap.addThreshold(2.0);
+    SC_THREAD(runtests);
+    SC_THREAD(runCpTests);
+  }
+
+  void runtests() {
+    spdlog::info("------ TEST: Constant-current charging crosses threshold");
+    // t = C * dv / i = 1 s
+    wait(ccCap.thresholdEvent(th1));
+    sc_assert(std::abs(sc_time_stamp().to_seconds() - 1.0) < 1.0e-9);
+    sc_assert(std::abs(ccCap.getVoltage() - 1.0) < 1.0e-9);
+
+    spdlog::info("------ TEST: Voltage is held at the supply voltage limit");
+    wait(3, SC_SEC);
+    sc_assert(vcc.read() == 3.0);
+    sc_assert(ccCap.getVoltage() == 3.0);
+
+    spdlog::info("------ TEST: Load current discharges the capacitor");
+    // Net current -1 mA, 1 V takes 1 s
+    iLoad.write(2.0e-3);
+    const auto start = sc_time_stamp();
+    wait(ccCap.thresholdEvent(th1));
+    sc_assert(std::abs((sc_time_stamp() - start).to_seconds() - 2.0) < 1.0e-9);
+
+    sc_assert(cpDone);
+    sc_stop();
+  }
+
+  void runCpTests() {
+    spdlog::info("------ TEST: Constant-power charging crosses threshold");
+    // No load: t = C (v^2 - v0^2) / (2 P) = 1.5 s
+    wait(cpCap.thresholdEvent(th2));
+    sc_assert(std::abs(sc_time_stamp().to_seconds() - 1.5) < 1.0e-9);
+    sc_assert(std::abs(cpCap.getVoltage() - 2.0) < 1.0e-9);
+    cpDone = true;
+  }
+
+  int th1;
+  int th2;
+  bool cpDone{false};
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
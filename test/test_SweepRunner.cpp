@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <systemc>
+#include "ps/PowerModelDatabase.hpp"
+#include "ps/SweepRunner.hpp"
+#include <unistd.h>
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  const std::string dbPath = "/tmp/test_SweepRunner_db.yaml";
+  const std::string specPath = "/tmp/test_SweepRunner.yaml";
+  const std::string resultPath = "/tmp/test_SweepRunner.csv";
+  {
+    std::ofstream f(dbPath, std::ios::out | std::ios::trunc);
+    f << "memory:\n"
+         "  read: 1.0e-11\n"
+         "  on: 1.0e-4\n";
+  }
+  {
+    std::ofstream f(specPath, std::ios::out | std::ios::trunc);
+    f << "database: " << dbPath << "\n"
+      << "workers: 3\n"
+         "output: /tmp/test_SweepRunner\n"
+         "parameters:\n"
+         "  \"memory read\": [1.0e-11, 2.0e-11]\n"
+         "  \"memory on\": {from: 1.0e-4, to: 3.0e-4, steps: 3}\n";
+  }
+
+  spdlog::info("------ TEST: Parameters expand to their cartesian product");
+  SweepRunner sweep(specPath);
+  const long cores = std::max(sysconf(_SC_NPROCESSORS_ONLN), 1L);
+  sc_assert(sweep.workers() == std::min(cores, 3L));
+  sc_assert(sweep.points().size() == 6);
+  sc_assert(sweep.points()[4].parameters[0].second == 2.0e-11);
+  sc_assert(std::abs(sweep.points()[4].parameters[1].second - 2.0e-4) <
+            1.0e-15);
+  sc_assert(sweep.points()[4].outputDir == "/tmp/test_SweepRunner/run4");
+
+  spdlog::info("------ TEST: Workers are clamped to the core count");
+  {
+    std::ofstream f(specPath, std::ios::out | std::ios::trunc);
+    f << "workers: 100000\n"
+         "parameters:\n"
+         "  \"memory read\": [1.0e-11]\n";
+  }
+  sc_assert(SweepRunner(specPath).workers() == cores);
+
+  spdlog::info("------ TEST: Workers see their overrides, results are merged");
+  const auto failed =
+      sweep.run([](const SweepRunner::Point &p) {
+        if (p.index == 5) {
+          throw std::runtime_error("failing on purpose");
+        }
+        const auto &db = PowerModelDatabase::get();
+        return SweepRunner::Values{
+            {"energy", 100 * db.getDouble("memory read") +
+                           db.getDouble("memory on")}};
+      },
+                resultPath);
+  sc_assert(failed == 1);
+  // The parent's database is not modified
+  sc_assert(PowerModelDatabase::get().getDouble("memory read") == 1.0e-11);
+
+  std::ifstream f(resultPath);
+  std::string line;
+  std::getline(f, line);
+  sc_assert(line == "run,memory read,memory on,status,energy");
+  std::getline(f, line);
+  sc_assert(line == "0,1e-11,0.0001,ok,0.000100001");
+  for (int i = 0; i < 5; ++i) {
+    std::getline(f, line);
+  }
+  sc_assert(line == "5,2e-11,0.0003,failed,");
+
+  PowerModelDatabase::get().clear();
+  std::remove(specPath.c_str());
+  std::remove(resultPath.c_str());
+  return false;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <systemc>
+#include "ps/ConstantCurrentState.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "ps/TelemetrySegment.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  PowerModelChannel ch{"ch", "none", sc_time(1, SC_US)};
+
+  SC_CTOR(tester) {
+    cpuOn = ch.registerState(
+        "cpu", std::make_shared<ConstantCurrentState>("on", 1.0e-3));
+    ch.registerState("radio",
+                     std::make_shared<ConstantCurrentState>("on", 2.0e-3));
+    ch.enableTelemetry(segment);
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    spdlog::info("------ TEST: Writer and reader round trip");
+    {
+      TelemetryWriter writer(segment + "_rt", {"a", std::string(100, 'b')});
+      TelemetryReader reader(segment + "_rt");
+      sc_assert(reader.moduleNames().size() == 2);
+      sc_assert(reader.moduleNames()[0] == "a");
+      sc_assert(reader.moduleNames()[1].size() ==
+                TelemetryWriter::nameLength - 1);
+
+      TelemetrySnapshot in;
+      in.time = 1.0;
+      in.supplyVoltage = 3.3;
+      in.totalEnergy = 2.0;
+      in.modulePower = {0.5, 0.25};
+      writer.publish(in);
+      TelemetrySnapshot out;
+      sc_assert(reader.read(out));
+      sc_assert(out.sequence == 2);
+      sc_assert(out.time == 1.0 && out.supplyVoltage == 3.3);
+      sc_assert(out.totalEnergy == 2.0);
+      sc_assert(out.modulePower[0] == 0.5 && out.modulePower[1] == 0.25);
+    }
+
+    spdlog::info("------ TEST: The segment is removed with its writer");
+    bool threw = false;
+    try {
+      TelemetryReader reader(segment + "_rt");
+    } catch (const std::runtime_error &) {
+      threw = true;
+    }
+    sc_assert(threw);
+
+    spdlog::info("------ TEST: The channel publishes every log timestep");
+    ch.setSupplyVoltage(1.0);
+    ch.reportState(cpuOn);
+    wait(1500, SC_NS);
+    TelemetryReader reader(segment);
+    sc_assert(reader.moduleNames().size() == 2);
+    TelemetrySnapshot s;
+    sc_assert(reader.read(s));
+    sc_assert(std::abs(s.time - 1.0e-6) < 1.0e-15);
+    sc_assert(s.supplyVoltage == 1.0);
+    sc_assert(std::abs(s.modulePower[0] - 1.0e-3) < 1.0e-12);
+    sc_assert(s.modulePower[1] == 0.0);
+    sc_assert(std::abs(s.staticPower - 1.0e-3) < 1.0e-12);
+
+    wait(1, SC_US);
+    sc_assert(reader.read(s));
+    sc_assert(std::abs(s.time - 2.0e-6) < 1.0e-15);
+    sc_assert(std::abs(s.totalEnergy - 2.0e-9) < 1.0e-18);
+
+    sc_stop();
+  }
+
+  const std::string segment = "fused_test_telemetry";
+  int cpuOn;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <systemc>
+#include <utility>
+#include "ps/ConstantCurrentState.hpp"
+#include "ps/LeakageCurrentState.hpp"
+#include "ps/PowerModelChannel.hpp"
+#include "ps/ThermalModel.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  PowerModelChannel ch{"ch", "none"};
+  ThermalModel thermal{"thermal", sc_time(1, SC_MS), 25.0};
+  sc_port<PowerModelChannelOutIf> outport{"outport"};
+
+  std::shared_ptr<LeakageCurrentState> leakage =
+      std::make_shared<LeakageCurrentState>("leak", 1.0e-6);
+  unsigned int node;
+  int sram;
+
+  SC_CTOR(tester) {
+    outport(ch);
+    thermal.powerModelPort(ch);
+
+    // 10 mW into a node with 1 mW/K to ambient, time constant 1 s
+    outport->registerState("cpu",
+                           std::make_shared<ConstantCurrentState>("on", 1e-2));
+    sram = outport->registerState("sram", leakage);
+    node = thermal.addNode(1.0e-3, 1.0e-3);
+    thermal.addModule(node, "cpu");
+    thermal.addLeakageState(node, "sram", leakage);
+    // Leakage must bypass the voltage-keyed quantization tables
+    ch.setVoltageQuantization(0.05);
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    ch.setSupplyVoltage(1.0);
+    ch.reportState(sram);
+
+    spdlog::info("------ TEST: Node heats up with the RC time constant");
+    wait(1, SC_SEC);
+    const double expected = 25.0 + 10.0 * (1.0 - std::exp(-1.0));
+    sc_assert(std::fabs(thermal.getTemperature(node) - expected) < 0.05);
+
+    spdlog::info("------ TEST: Node settles at ambient + P/G");
+    wait(9, SC_SEC);
+    sc_assert(std::fabs(thermal.getTemperature(node) - 35.0) < 0.05);
+
+    spdlog::info("------ TEST: Leakage doubles per 10 K");
+    sc_assert(std::fabs(leakage->calculateCurrent(1.0) / 2.0e-6 - 1.0) < 0.02);
+
+    spdlog::info("------ TEST: The channel follows the leakage current");
+    sc_assert(std::fabs(ch.getStaticCurrent() -
+                        (1.0e-2 + leakage->calculateCurrent(1.0))) < 1e-15);
+
+    spdlog::info("------ TEST: Leakage energy is integrated as it heats up");
+    // Integral of 1 uA * 2^(1 - exp(-t)) over 10 s is 18.8 uJ
+    const double energy = ch.getModuleEnergy(ch.getModuleId("sram"));
+    sc_assert(energy > 1.8e-5 && energy < 1.95e-5);
+
+    sc_stop();
+  }
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  spdlog::info("------ TEST: Non-positive leakage parameters are rejected");
+  for (const auto &params : {std::make_pair(0.0, 0.25),
+                             std::make_pair(-10.0, 0.25),
+                             std::make_pair(10.0, 0.0),
+                             std::make_pair(10.0, std::nan(""))}) {
+    auto success = false;
+    try {
+      LeakageCurrentState("bad", 1.0e-6, 25.0, params.first, params.second);
+    } catch (const std::invalid_argument &e) {
+      success = true;
+    }
+    sc_assert(success);
+  }
+
+  tester t("tester");
+  sc_start();
+  return false;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <spdlog/spdlog.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <systemc>
+#include "ps/ConstantCurrentState.hpp"
+#include "ps/LookupTableBank.hpp"
+#include "ps/LookupTableCurrentState.hpp"
+#include "ps/PowerModelChannel.hpp"
+
+using namespace sc_core;
+
+SC_MODULE(tester) {
+ public:
+  PowerModelChannel ch{"ch", "none"};
+  PowerModelChannel lut{"lut", "none"};
+
+  SC_CTOR(tester) {
+    cpuOn = ch.registerState(
+        "cpu", std::make_shared<ConstantCurrentState>("on", 1.0e-3));
+    radioOn = ch.registerState(
+        "radio", std::make_shared<ConstantCurrentState>("on", 2.0e-3));
+    rf = ch.addVoltageDomain("rf");
+    ch.setModuleDomain("radio", rf);
+
+    spdlog::info("------ TEST: Lookup table models are kept in domain 0");
+    const auto bank =
+        std::make_shared<LookupTableBank>(std::vector<double>{1.0, 2.0});
+    lut.registerState("sensor",
+                      std::make_shared<LookupTableCurrentState>(
+                          "on", bank, std::vector<double>{1.0e-6, 2.0e-6}));
+    const auto lutRf = lut.addVoltageDomain("rf");
+    auto success = false;
+    try {
+      lut.setModuleDomain("sensor", lutRf);
+    } catch (const std::invalid_argument &e) {
+      success = true;
+    }
+    sc_assert(success);
+    SC_THREAD(runtests);
+  }
+
+  void runtests() {
+    spdlog::info("------ TEST: Domains have their own supply voltage");
+    ch.setSupplyVoltage(1.0);
+    ch.setSupplyVoltage(rf, 3.0);
+    sc_assert(ch.getSupplyVoltage() == 1.0);
+    sc_assert(ch.getSupplyVoltage(rf) == 3.0);
+
+    spdlog::info("------ TEST: State energy uses the domain voltage");
+    const auto cpu = ch.getModuleId("cpu");
+    const auto radio = ch.getModuleId("radio");
+    ch.reportState(cpuOn);
+    ch.reportState(radioOn);
+    wait(1, SC_US);
+    sc_assert(std::abs(ch.getModuleEnergy(cpu) - 1.0e-9) < 1.0e-18);
+    sc_assert(std::abs(ch.getModuleEnergy(radio) - 6.0e-9) < 1.0e-18);
+    sc_assert(std::abs(ch.getTotalEnergy() - 7.0e-9) < 1.0e-18);
+
+    spdlog::info("------ TEST: Static current is referred to the main supply");
+    sc_assert(std::abs(ch.getStaticCurrent() - 7.0e-3) < 1.0e-12);
+
+    spdlog::info("------ TEST: Changing one domain leaves the other alone");
+    ch.setSupplyVoltage(rf, 1.5);
+    wait(1, SC_US);
+    sc_assert(std::abs(ch.getModuleEnergy(cpu) - 2.0e-9) < 1.0e-18);
+    sc_assert(std::abs(ch.getModuleEnergy(radio) - 9.0e-9) < 1.0e-18);
+
+    sc_stop();
+  }
+
+  int cpuOn;
+  int radioOn;
+  unsigned int rf;
+};
+
+int sc_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
+  tester t("tester");
+
+  sc_start();
+  return false;
+}
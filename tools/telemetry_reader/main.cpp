@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2021, University of Southampton and Contributors.
+ * All rights reserved.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "ps/TelemetrySegment.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <spdlog/fmt/fmt.h>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * telemetry_reader <segment> [interval_ms]
+ *
+ * Prints the live telemetry published by a PowerModelChannel with
+ * enableTelemetry(segment). Prints one snapshot and exits if interval_ms is
+ * 0 (the default), otherwise prints a snapshot every interval_ms until the
+ * simulation removes the segment.
+ */
+
+namespace {
+void print(const TelemetryReader &reader, const TelemetrySnapshot &s) {
+  fmt::print("t = {:.9f} s  seq {:d}\n", s.time, s.sequence);
+  fmt::print("  supply voltage  {:12.6g} V\n", s.supplyVoltage);
+  fmt::print("  static power    {:12.6g} W\n", s.staticPower);
+  fmt::print("  dynamic power   {:12.6g} W\n", s.dynamicPower);
+  fmt::print("  total energy    {:12.6g} J\n", s.totalEnergy);
+  const auto &names = reader.moduleNames();
+  for (unsigned int i = 0; i < names.size(); ++i) {
+    fmt::print("  {:<32s}{:12.6g} W\n", names[i], s.modulePower[i]);
+  }
+  std::fflush(stdout);
+}
+
+//! Whether the segment still exists. Our mapping outlives its removal.
+bool segmentExists(const std::string &segmentName) {
+  const int fd = shm_open(("/" + segmentName).c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return false;
+  }
+  ::close(fd);
+  return true;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2 || argc > 3) {
+    fmt::print(stderr, "Usage: {:s} <segment> [interval_ms]\n", argv[0]);
+    return 1;
+  }
+  const std::string segmentName = argv[1];
+  const long interval = argc == 3 ? std::strtol(argv[2], nullptr, 10) : 0;
+
+  try {
+    const TelemetryReader reader(segmentName);
+    TelemetrySnapshot s;
+    do {
+      if (reader.read(s)) {
+        print(reader, s);
+      } else {
+        fmt::print(stderr, "No consistent snapshot, retrying\n");
+      }
+      if (interval > 0) {
+        usleep(interval * 1000);
+      }
+    } while (interval > 0 && segmentExists(segmentName));
+  } catch (const std::exception &e) {
+    fmt::print(stderr, "{:s}\n", e.what());
+    return 1;
+  }
+  return 0;
+}